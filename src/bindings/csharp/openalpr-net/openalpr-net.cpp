@@ -338,7 +338,7 @@ namespace openalprnet {
 	{
 	public:
 		// Allocate the native object on the C++ Heap via a constructor
-		AlprNet(System::String^ country, System::String^ configFile, System::String^ runtimeDir) : m_Impl( new Alpr(marshal_as<std::string>(country), marshal_as<std::string>(configFile), marshal_as<std::string>(runtimeDir)) ) { }
+		AlprNet(System::String^ country, System::String^ configFile, System::String^ runtimeDir) : m_Impl( new Alpr(marshal_as<std::string>(country), marshal_as<std::string>(configFile), marshal_as<std::string>(runtimeDir)) ), m_includeCharacterDetails(true), m_grayscaleOnly(m_Impl->isGrayscaleOnly()) { }
 
 		// Deallocate the native object on a destructor
 		~AlprNet(){
@@ -365,6 +365,29 @@ namespace openalprnet {
 			}
 		}
 
+		property bool IncludeCharacterDetails {
+			bool get() {
+				return m_includeCharacterDetails;
+			}
+			void set( bool includeCharacterDetails ) {
+				m_includeCharacterDetails = includeCharacterDetails;
+				m_Impl->setIncludeCharacterDetails(includeCharacterDetails);
+			}
+		}
+
+		/// <summary>
+		/// Processes images as grayscale only.  Pass raw pixel data with 1 byte per pixel.
+		/// </summary>
+		property bool GrayscaleOnly {
+			bool get() {
+				return m_grayscaleOnly;
+			}
+			void set( bool grayscaleOnly ) {
+				m_grayscaleOnly = grayscaleOnly;
+				m_Impl->setGrayscaleOnly(grayscaleOnly);
+			}
+		}
+
 		property System::String^ DefaultRegion {
 			System::String^ get() {
 				return m_defaultRegion;
@@ -437,13 +460,18 @@ namespace openalprnet {
 		}
 
 		/// <summary>
-		/// Recognize from raw pixel data
+		/// Recognize from raw pixel data, 1 byte per pixel (gray) or 3 (BGR)
 		/// </summary>
 		AlprResultsNet^ recognize(cli::array<unsigned char>^ pixelData, int bytesPerPixel, int imgWidth, int imgHeight, List<System::Drawing::Rectangle>^ regionsOfInterest) {
-			unsigned char* p = AlprHelper::ToCharPtr(pixelData);
+			// A short array would be read past its end
+			if ((bytesPerPixel != 1 && bytesPerPixel != 3) || imgWidth <= 0 || imgHeight <= 0 ||
+				pixelData->Length < (double) imgWidth * imgHeight * bytesPerPixel)
+				throw gcnew System::ArgumentException("pixelData must hold imgWidth * imgHeight * bytesPerPixel bytes, with 1 or 3 bytes per pixel", "pixelData");
+
+			// The array stays pinned while it is read in place, so the pixels aren't copied
+			pin_ptr<unsigned char> p = &pixelData[0];
 			std::vector<AlprRegionOfInterest> rois = AlprHelper::ToVector(regionsOfInterest);
 			AlprResults results = m_Impl->recognize(p, bytesPerPixel, imgWidth, imgHeight, rois);
-			free(p); // ?? memory leak?
 			return gcnew AlprResultsNet(results);
 		}
 
@@ -465,6 +493,8 @@ namespace openalprnet {
 		Alpr * m_Impl;
 		int m_topN;
 		bool m_detectRegion;
+		bool m_includeCharacterDetails;
+		bool m_grayscaleOnly;
 		System::String^ m_defaultRegion;
 	};
 }
@@ -47,6 +47,14 @@ JNIEXPORT jstring JNICALL Java_com_openalpr_jni_Alpr_native_1recognize__Ljava_la
 JNIEXPORT jstring JNICALL Java_com_openalpr_jni_Alpr_native_1recognize___3B
   (JNIEnv *, jobject, jbyteArray);
 
+/*
+ * Class:     com_openalpr_jni_Alpr
+ * Method:    native_recognize
+ * Signature: ([BIII)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_com_openalpr_jni_Alpr_native_1recognize___3BIII
+  (JNIEnv *, jobject, jbyteArray, jint, jint, jint);
+
 /*
  * Class:     com_openalpr_jni_Alpr
  * Method:    set_default_region
@@ -71,6 +79,22 @@ JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_detect_1region
 JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_set_1top_1n
   (JNIEnv *, jobject, jint);
 
+/*
+ * Class:     com_openalpr_jni_Alpr
+ * Method:    include_character_details
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_include_1character_1details
+  (JNIEnv *, jobject, jboolean);
+
+/*
+ * Class:     com_openalpr_jni_Alpr
+ * Method:    grayscale_only
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_grayscale_1only
+  (JNIEnv *, jobject, jboolean);
+
 /*
  * Class:     com_openalpr_jni_Alpr
  * Method:    get_version
@@ -88,6 +88,31 @@ JNIEXPORT jstring JNICALL Java_com_openalpr_jni_Alpr_native_1recognize___3B
     return env->NewStringUTF(json.c_str());
   }
 
+JNIEXPORT jstring JNICALL Java_com_openalpr_jni_Alpr_native_1recognize___3BIII
+  (JNIEnv *env, jobject thisObj, jbyteArray jpixelData, jint bytesPerPixel, jint imgWidth, jint imgHeight)
+  {
+    // A short array would be read past its end
+    if ((bytesPerPixel != 1 && bytesPerPixel != 3) || imgWidth <= 0 || imgHeight <= 0 ||
+        env->GetArrayLength(jpixelData) < (jlong) imgWidth * imgHeight * bytesPerPixel)
+    {
+      env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"),
+                    "pixelData must hold imgWidth * imgHeight * bytesPerPixel bytes, with 1 or 3 bytes per pixel");
+      return NULL;
+    }
+
+    // Reads the pixels in place when the JVM allows it, so gray frames aren't copied
+    jbyte* pixelData = env->GetByteArrayElements(jpixelData, NULL);
+
+    std::vector<AlprRegionOfInterest> regionsOfInterest;
+    AlprResults results = nativeAlpr->recognize(reinterpret_cast<unsigned char*>(pixelData), bytesPerPixel, imgWidth, imgHeight, regionsOfInterest);
+
+    env->ReleaseByteArrayElements(jpixelData, pixelData, JNI_ABORT);
+
+    std::string json = Alpr::toJson(results);
+
+    return env->NewStringUTF(json.c_str());
+  }
+
 JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_set_1default_1region
   (JNIEnv *env, jobject thisObj, jstring jdefault_region)
   {
@@ -111,6 +136,18 @@ JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_set_1top_1n
     nativeAlpr->setTopN(top_n);
   }
 
+JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_include_1character_1details
+  (JNIEnv *env, jobject thisObj, jboolean include_character_details)
+  {
+    nativeAlpr->setIncludeCharacterDetails(include_character_details);
+  }
+
+JNIEXPORT void JNICALL Java_com_openalpr_jni_Alpr_grayscale_1only
+  (JNIEnv *env, jobject thisObj, jboolean grayscale_only)
+  {
+    nativeAlpr->setGrayscaleOnly(grayscale_only);
+  }
+
 JNIEXPORT jstring JNICALL Java_com_openalpr_jni_Alpr_get_1version
   (JNIEnv *env, jobject thisObj)
   {
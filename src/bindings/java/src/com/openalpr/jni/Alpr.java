@@ -13,10 +13,13 @@ public class Alpr {
     private native boolean is_loaded();
     private native String native_recognize(String imageFile);
     private native String native_recognize(byte[] imageBytes);
+    private native String native_recognize(byte[] pixelData, int bytesPerPixel, int imgWidth, int imgHeight);
 
     private native void set_default_region(String region);
     private native void detect_region(boolean detectRegion);
     private native void set_top_n(int topN);
+    private native void include_character_details(boolean includeCharacterDetails);
+    private native void grayscale_only(boolean grayscaleOnly);
     private native String get_version();
 
 
@@ -49,6 +52,14 @@ public class Alpr {
         return new AlprResults(json);
     }
 
+    // Recognize from raw pixel data, 1 byte per pixel (gray) or 3 (BGR).  Throws IllegalArgumentException
+    // if pixelData is shorter than imgWidth * imgHeight * bytesPerPixel.
+    public AlprResults recognize(byte[] pixelData, int bytesPerPixel, int imgWidth, int imgHeight)
+    {
+        String json = native_recognize(pixelData, bytesPerPixel, imgWidth, imgHeight);
+        return new AlprResults(json);
+    }
+
 
     public void setTopN(int topN)
     {
@@ -65,6 +76,16 @@ public class Alpr {
         detect_region(detectRegion);
     }
 
+    public void setIncludeCharacterDetails(boolean includeCharacterDetails)
+    {
+        include_character_details(includeCharacterDetails);
+    }
+
+    public void setGrayscaleOnly(boolean grayscaleOnly)
+    {
+        grayscale_only(grayscaleOnly);
+    }
+
     public String getVersion()
     {
         return get_version();
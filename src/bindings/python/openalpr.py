@@ -28,6 +28,10 @@ class Alpr():
         self._recognize_array_func.restype = ctypes.c_void_p
         self._recognize_array_func.argtypes = [ctypes.POINTER(ctypes.c_ubyte), ctypes.c_uint]
 
+        self._recognize_raw_image_func = self._openalprpy_lib.recognizeRawImage
+        self._recognize_raw_image_func.restype = ctypes.c_void_p
+        self._recognize_raw_image_func.argtypes = [ctypes.POINTER(ctypes.c_ubyte), ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+
         self._free_json_mem_func = self._openalprpy_lib.freeJsonMem
 
 
@@ -41,6 +45,12 @@ class Alpr():
         self._set_top_n_func = self._openalprpy_lib.setTopN
         self._set_top_n_func.argtypes = [ctypes.c_int]
 
+        self._set_include_character_details_func = self._openalprpy_lib.setIncludeCharacterDetails
+        self._set_include_character_details_func.argtypes = [ctypes.c_bool]
+
+        self._set_grayscale_only_func = self._openalprpy_lib.setGrayscaleOnly
+        self._set_grayscale_only_func.argtypes = [ctypes.c_bool]
+
         self._get_version_func = self._openalprpy_lib.getVersion
         self._get_version_func.restype = ctypes.c_void_p
 
@@ -71,6 +81,21 @@ class Alpr():
 
         return response_obj
 
+    def recognize_raw_image(self, pixel_data, bytes_per_pixel, width, height):
+        # pixel_data holds the rows of the image, 1 byte per pixel for gray or 3 for BGR
+        if bytes_per_pixel not in (1, 3):
+            raise ValueError("bytes_per_pixel must be 1 (gray) or 3 (BGR)")
+        if width <= 0 or height <= 0 or len(pixel_data) < width * height * bytes_per_pixel:
+            raise ValueError("pixel_data must hold width * height * bytes_per_pixel bytes")
+
+        pb = ctypes.cast(pixel_data, ctypes.POINTER(ctypes.c_ubyte))
+        ptr = self._recognize_raw_image_func(pb, len(pixel_data), bytes_per_pixel, width, height)
+        json_data = ctypes.cast(ptr, ctypes.c_char_p).value
+        response_obj = json.loads(json_data)
+        self._free_json_mem_func(ctypes.c_void_p(ptr))
+
+        return response_obj
+
     def get_version(self):
 
         ptr = self._get_version_func()
@@ -88,4 +113,10 @@ class Alpr():
     def set_detect_region(self, enabled):
         self._set_detect_region_func(enabled)
 
+    def set_include_character_details(self, enabled):
+        self._set_include_character_details_func(enabled)
+
+    def set_grayscale_only(self, enabled):
+        self._set_grayscale_only_func(enabled)
+
 
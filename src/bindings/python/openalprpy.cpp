@@ -103,6 +103,25 @@ extern "C" {
       return membuffer;
     }
 
+  OPENALPR_EXPORT char* recognizeRawImage(unsigned char* pixelData, int len, int bytesPerPixel, int imgWidth, int imgHeight)
+    {
+      // Returns NULL rather than read past the end of a buffer that doesn't hold the image
+      if ((bytesPerPixel != 1 && bytesPerPixel != 3) || imgWidth <= 0 || imgHeight <= 0 ||
+          len < (double) imgWidth * imgHeight * bytesPerPixel)
+        return NULL;
+
+      // The pixels are read in place, so gray frames are passed through without a copy
+      std::vector<AlprRegionOfInterest> regionsOfInterest;
+      AlprResults results = nativeAlpr->recognize(pixelData, bytesPerPixel, imgWidth, imgHeight, regionsOfInterest);
+      std::string json = Alpr::toJson(results);
+
+      int strsize = sizeof(char) * (strlen(json.c_str()) + 1);
+      char* membuffer = (char*)malloc(strsize);
+      strcpy(membuffer, json.c_str());
+
+      return membuffer;
+    }
+
   OPENALPR_EXPORT void setDefaultRegion(char* cdefault_region)
     {
       // Convert strings from java to C++ and release resources
@@ -121,6 +140,16 @@ extern "C" {
       nativeAlpr->setTopN(top_n);
     }
 
+  OPENALPR_EXPORT void setIncludeCharacterDetails(bool include_character_details)
+    {
+      nativeAlpr->setIncludeCharacterDetails(include_character_details);
+    }
+
+  OPENALPR_EXPORT void setGrayscaleOnly(bool grayscale_only)
+    {
+      nativeAlpr->setGrayscaleOnly(grayscale_only);
+    }
+
   OPENALPR_EXPORT char* getVersion()
     {
       std::string version = nativeAlpr->getVersion();
@@ -11,7 +11,6 @@
 #include "tclap/CmdLine.h"
 #include "alpr.h"
 #include "openalpr/simpleini/simpleini.h"
-#include "openalpr/cjson.h"
 #include "support/tinythread.h"
 #include <curl/curl.h>
 #include "support/timing.h"
@@ -293,6 +292,8 @@ void streamRecognitionThread(void* arg)
   
   Alpr alpr(tdata->country_code, tdata->config_file);
   alpr.setTopN(tdata->top_n);
+  // The JSON sent to the queue doesn't carry the per-character details
+  alpr.setIncludeCharacterDetails(false);
   
   MotionDetector motiondetector(tdata->motion_mog_history_size, tdata->motion_mog_var_threshold, tdata->motion_mog_detect_shadows,
                                 tdata->motion_debug_show_images);
@@ -302,6 +303,7 @@ void streamRecognitionThread(void* arg)
   int framenum = 0;
   
   LoggingVideoBuffer videoBuffer(logger);
+  videoBuffer.setGrayscale(alpr.isGrayscaleOnly());
   
   videoBuffer.connect(tdata->stream_url, 5);
   
@@ -364,28 +366,17 @@ void streamRecognitionThread(void* arg)
 	  cv::imwrite(ss.str(), latestFrame);
 	}
 	
-	// Update the JSON content to include UUID and camera ID
-  
-	std::string json = alpr.toJson(results);
-	
-	cJSON *root = cJSON_Parse(json.c_str());
-	cJSON_AddStringToObject(root,	"uuid",		uuid.c_str());
-	cJSON_AddNumberToObject(root,	"camera_id",	tdata->camera_id);
-	cJSON_AddStringToObject(root, 	"site_id", 	tdata->site_id.c_str());
-	cJSON_AddNumberToObject(root,	"img_width",	latestFrame.cols);
-	cJSON_AddNumberToObject(root,	"img_height",	latestFrame.rows);
+	// Add the UUID and camera ID to the JSON content
+	std::vector<AlprJsonField> metadata;
+	metadata.push_back(AlprJsonField("uuid", uuid));
+	metadata.push_back(AlprJsonField("camera_id", tdata->camera_id));
+	metadata.push_back(AlprJsonField("site_id", tdata->site_id));
 
         // Add the company ID to the output if configured
         if (tdata->company_id.length() > 0)
-          cJSON_AddStringToObject(root, 	"company_id", 	tdata->company_id.c_str());
+          metadata.push_back(AlprJsonField("company_id", tdata->company_id));
 
-	char *out;
-	out=cJSON_PrintUnformatted(root);
-	cJSON_Delete(root);
-	
-	std::string response(out);
-	
-	free(out);
+	std::string response = alpr.toJson(results, metadata);
 	
 	// Push the results to the Beanstalk queue
 	for (int j = 0; j < results.plates.size(); j++)
@@ -132,6 +132,9 @@ int main( int argc, const char** argv )
     return 1;
   }
 
+  // Images are decoded straight to gray when the pipeline only uses gray
+  int imreadFlags = alpr.isGrayscaleOnly() ? CV_LOAD_IMAGE_GRAYSCALE : CV_LOAD_IMAGE_COLOR;
+
   if (filename.empty())
   {
     std::string filename;
@@ -139,7 +142,7 @@ int main( int argc, const char** argv )
     {
       if (fileExists(filename.c_str()))
       {
-	frame = cv::imread( filename );
+	frame = cv::imread( filename, imreadFlags );
 	detectandshow( &alpr, frame, "", outputJson);
       }
       else
@@ -173,6 +176,7 @@ int main( int argc, const char** argv )
     int framenum = 0;
     
     VideoBuffer videoBuffer;
+    videoBuffer.setGrayscale(alpr.isGrayscaleOnly());
     
     videoBuffer.connect(filename, 5);
     
@@ -232,7 +236,7 @@ int main( int argc, const char** argv )
   {
     if (fileExists(filename.c_str()))
     {
-      frame = cv::imread( filename );
+      frame = cv::imread( filename, imreadFlags );
 
       bool plate_found = detectandshow( &alpr, frame, "", outputJson);
       
@@ -256,7 +260,7 @@ int main( int argc, const char** argv )
       {
         std::string fullpath = filename + "/" + files[i];
         std::cout << fullpath << std::endl;
-        frame = cv::imread( fullpath.c_str() );
+        frame = cv::imread( fullpath.c_str(), imreadFlags );
         if (detectandshow( &alpr, frame, "", outputJson))
         {
           //while ((char) cv::waitKey(50) != 'c') { }
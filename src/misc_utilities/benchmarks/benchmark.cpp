@@ -29,8 +29,10 @@
 #include "alpr_impl.h"
 
 #include "endtoendtest.h"
+#include "microbenchmarks.h"
 
 #include "detection/detectorfactory.h"
+#include "ocr/ocrfactory.h"
 #include "support/filesystem.h"
 
 using namespace std;
@@ -67,7 +69,7 @@ int main( int argc, const char** argv )
     printf("Use:\n\t%s [country] [benchmark name] [img input dir] [results output dir]\n",argv[0]);
     printf("\tex: %s us speed ./speed/usimages ./speed\n",argv[0]);
     printf("\n");
-    printf("\ttest names are: speed, segocr, detection\n\n" );
+    printf("\ttest names are: speed, segocr, detection, endtoend, histogram, platecorners, segmentation, ocrbackends, postprocess, stateid, json, jsonparse, resultassembly, steadystate\n\n" );
     return 0;
   }
 
@@ -168,7 +170,7 @@ int main( int argc, const char** argv )
 
     Detector* plateDetector = createDetector(&config);
     StateIdentifier stateIdentifier(&config);
-    OCR ocr(&config);
+    OCR* ocr = createOcr(&config);
 
     vector<double> endToEndTimes;
     vector<double> regionDetectionTimes;
@@ -229,14 +231,14 @@ int main( int argc, const char** argv )
             lpAnalysisPositiveTimes.push_back(analysisTime);
 
             getTimeMonotonic(&startTime);
-            ocr.performOCR(&pipeline_data);
+            ocr->performOCR(&pipeline_data);
             getTimeMonotonic(&endTime);
             double ocrTime = diffclock(startTime, endTime);
-            cout << "\tRegion " << z << ": OCR time: " << ocrTime << "ms." << endl;
+            cout << "\tRegion " << z << ": OCR time: " << ocrTime << "ms. (" << pipeline_data.ocrThresholdsUsed << " of " << pipeline_data.thresholds.size() << " thresholds)" << endl;
             ocrTimes.push_back(ocrTime);
 
             getTimeMonotonic(&startTime);
-            ocr.postProcessor.analyze("", 25);
+            ocr->postProcessor.analyze("", 25);
             getTimeMonotonic(&endTime);
             double postProcessTime = diffclock(startTime, endTime);
             cout << "\tRegion " << z << ": PostProcess time: " << postProcessTime << "ms." << endl;
@@ -276,11 +278,15 @@ int main( int argc, const char** argv )
 
     cout << "OCR Time Statistics:" << endl;
     outputStats(ocrTimes);
+    cout << "OCR glyph cache: " << ocr->getGlyphCacheHits() << " hits, " << ocr->getGlyphCacheMisses() << " misses" << endl;
     cout << endl;
 
     cout << "Post Processing Time Statistics:" << endl;
     outputStats(postProcessTimes);
     cout << endl;
+
+    delete ocr;
+    delete plateDetector;
   }
   else if (benchmarkName.compare("endtoend") == 0)
   {
@@ -288,6 +294,46 @@ int main( int argc, const char** argv )
     e2eTest.runTest(country, files);
     
   }
+  else if (benchmarkName.compare("histogram") == 0)
+  {
+    benchmarkVerticalHistogram(country, inDir, files);
+  }
+  else if (benchmarkName.compare("platecorners") == 0)
+  {
+    benchmarkPlateCorners(country, inDir, outDir, files);
+  }
+  else if (benchmarkName.compare("segmentation") == 0)
+  {
+    benchmarkSegmentation(country, inDir, files);
+  }
+  else if (benchmarkName.compare("ocrbackends") == 0)
+  {
+    benchmarkOcrBackends(country, inDir, files);
+  }
+  else if (benchmarkName.compare("postprocess") == 0)
+  {
+    benchmarkPostProcess(country, inDir, files);
+  }
+  else if (benchmarkName.compare("stateid") == 0)
+  {
+    benchmarkStateId(country, inDir, files);
+  }
+  else if (benchmarkName.compare("json") == 0)
+  {
+    benchmarkJsonSerialization();
+  }
+  else if (benchmarkName.compare("jsonparse") == 0)
+  {
+    benchmarkJsonParsing();
+  }
+  else if (benchmarkName.compare("resultassembly") == 0)
+  {
+    benchmarkResultAssembly(country, inDir, files);
+  }
+  else if (benchmarkName.compare("steadystate") == 0)
+  {
+    benchmarkSteadyState(country, inDir, files);
+  }
 }
 
 void outputStats(vector<double> datapoints)
@@ -0,0 +1,1270 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "microbenchmarks.h"
+
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <queue>
+#include <set>
+
+#include "config.h"
+#include "utility.h"
+#include "segmentation/verticalhistogram.h"
+#include "detection/detectorfactory.h"
+#include "licenseplatecandidate.h"
+#include "ocr/tesseractocr.h"
+#include "ocr/glyphocr.h"
+#include "ocr/ocrfactory.h"
+#include "stateidentifier.h"
+#include "alpr.h"
+#include "alpr_impl.h"
+#include "cjson.h"
+#include "support/allocationcounter.h"
+#include "support/filesystem.h"
+
+using namespace std;
+using namespace cv;
+using namespace alpr;
+
+// Loads every image in the directory as a grayscale crop scaled to the OCR size
+static vector<Mat> loadOcrSizedCrops(Config* config, string inDir, vector<string> files)
+{
+  vector<Mat> crops;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str(), CV_LOAD_IMAGE_GRAYSCALE);
+      if (frame.empty())
+        continue;
+
+      Mat crop;
+      resize(frame, crop, Size(config->ocrImageWidthPx, config->ocrImageHeightPx));
+      crops.push_back(crop);
+    }
+  }
+
+  return crops;
+}
+
+// The column-major implementation that VerticalHistogram used previously
+static int legacyVerticalHistogram(Mat inputImage, Mat mask, vector<int>& colHeights, Mat& histoImg)
+{
+  int highestPeak = 0;
+  vector<double> data;
+
+  colHeights.clear();
+  histoImg = Mat::zeros(inputImage.size(), CV_8U);
+
+  for (int col = 0; col < inputImage.cols; col++)
+  {
+    int columnCount = 0;
+
+    for (int row = 0; row < inputImage.rows; row++)
+    {
+      if (inputImage.at<uchar>(row, col) > 0 && mask.at<uchar>(row, col) > 0)
+        columnCount++;
+    }
+
+    colHeights.push_back(columnCount);
+    if (columnCount > highestPeak)
+      highestPeak = columnCount;
+
+    data.push_back(columnCount);
+    for (; columnCount > 0; columnCount--)
+      histoImg.at<uchar>(inputImage.rows - columnCount, col) = 255;
+  }
+
+  return highestPeak;
+}
+
+void benchmarkVerticalHistogram(string country, string inDir, vector<string> files)
+{
+  const int ITERATIONS = 200;
+
+  Config config(country);
+  config.debugOff();
+
+  vector<Mat> crops = loadOcrSizedCrops(&config, inDir, files);
+  if (crops.size() == 0)
+  {
+    cout << "No images found in " << inDir << endl;
+    return;
+  }
+
+  // Use the real thresholds along with a mask covering the middle of the crop, similar to a text line polygon
+  vector<Mat> thresholds;
+  vector<Mat> masks;
+  for (unsigned int i = 0; i < crops.size(); i++)
+  {
+    vector<Mat> cropThresholds = produceThresholds(crops[i], &config);
+    Mat mask = Mat::zeros(crops[i].size(), CV_8U);
+    rectangle(mask, Rect(0, crops[i].rows / 6, crops[i].cols, (crops[i].rows * 2) / 3), Scalar(255,255,255), -1);
+
+    for (unsigned int t = 0; t < cropThresholds.size(); t++)
+    {
+      thresholds.push_back(cropThresholds[t]);
+      masks.push_back(mask);
+    }
+  }
+
+  cout << "Vertical histogram: " << thresholds.size() << " thresholds of " << config.ocrImageWidthPx << "x" << config.ocrImageHeightPx
+       << " px, " << ITERATIONS << " iterations" << endl;
+
+  // Both implementations must produce the same column heights
+  int mismatches = 0;
+  for (unsigned int i = 0; i < thresholds.size(); i++)
+  {
+    vector<int> legacyHeights;
+    Mat legacyImg;
+    legacyVerticalHistogram(thresholds[i], masks[i], legacyHeights, legacyImg);
+
+    VerticalHistogram histogram(thresholds[i], masks[i], true);
+    for (unsigned int col = 0; col < legacyHeights.size(); col++)
+    {
+      if (histogram.getHeightAt(col) != legacyHeights[col])
+      {
+        mismatches++;
+        break;
+      }
+    }
+    if (countNonZero(legacyImg != histogram.histoImg) > 0)
+      mismatches++;
+  }
+  cout << " -- Mismatched histograms: " << mismatches << endl;
+
+  timespec startTime;
+  timespec endTime;
+
+  int checksum = 0;
+  getTimeMonotonic(&startTime);
+  for (int iter = 0; iter < ITERATIONS; iter++)
+  {
+    for (unsigned int i = 0; i < thresholds.size(); i++)
+    {
+      vector<int> legacyHeights;
+      Mat legacyImg;
+      checksum += legacyVerticalHistogram(thresholds[i], masks[i], legacyHeights, legacyImg);
+    }
+  }
+  getTimeMonotonic(&endTime);
+  double legacyTime = diffclock(startTime, endTime);
+
+  getTimeMonotonic(&startTime);
+  for (int iter = 0; iter < ITERATIONS; iter++)
+  {
+    for (unsigned int i = 0; i < thresholds.size(); i++)
+    {
+      VerticalHistogram histogram(thresholds[i], masks[i]);
+      checksum += histogram.getHeightAt(0);
+    }
+  }
+  getTimeMonotonic(&endTime);
+  double currentTime = diffclock(startTime, endTime);
+
+  double perCall = ITERATIONS * thresholds.size();
+  cout << " -- Column-major (previous): " << legacyTime / perCall << "ms per histogram" << endl;
+  cout << " -- Row-major (current):     " << currentTime / perCall << "ms per histogram" << endl;
+  if (currentTime > 0)
+    cout << " -- Speedup: " << legacyTime / currentTime << "x" << endl;
+  cout << " (checksum " << checksum << ")" << endl;
+}
+
+void benchmarkPlateCorners(string country, string inDir, string outDir, vector<string> files)
+{
+  Config config(country);
+  config.debugOff();
+
+  Detector* plateDetector = createDetector(&config);
+
+  vector<string> recordedLines;
+  string referencePath = outDir + "/platecorners_reference.txt";
+  if (fileExists(referencePath.c_str()))
+  {
+    ifstream referenceFile(referencePath.c_str());
+    string line;
+    while (getline(referenceFile, line))
+      recordedLines.push_back(line);
+  }
+
+  string outputPath = outDir + "/platecorners.txt";
+  ofstream outputFile(outputPath.c_str());
+
+  timespec startTime;
+  timespec endTime;
+  double totalTime = 0;
+  int regionCount = 0;
+  int mismatches = 0;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str());
+
+      vector<PlateRegion> regions = plateDetector->detect(frame);
+
+      for (unsigned int z = 0; z < regions.size(); z++)
+      {
+        PipelineData pipeline_data(frame, regions[z].rect, &config);
+
+        getTimeMonotonic(&startTime);
+        LicensePlateCandidate lp(&pipeline_data);
+        lp.recognize();
+        getTimeMonotonic(&endTime);
+        totalTime += diffclock(startTime, endTime);
+        regionCount++;
+
+        stringstream ss;
+        ss << files[i] << " " << z;
+        for (unsigned int c = 0; c < pipeline_data.plate_corners.size(); c++)
+          ss << " " << pipeline_data.plate_corners[c].x << "," << pipeline_data.plate_corners[c].y;
+
+        string line = ss.str();
+        outputFile << line << endl;
+
+        size_t lineIndex = regionCount - 1;
+        if (recordedLines.size() > 0 && (lineIndex >= recordedLines.size() || recordedLines[lineIndex] != line))
+        {
+          mismatches++;
+          cout << "Corner mismatch: " << line << endl;
+        }
+      }
+    }
+  }
+
+  delete plateDetector;
+
+  cout << "Plate corners: " << regionCount << " regions, avg candidate analysis time: " << (regionCount > 0 ? totalTime / regionCount : 0) << "ms" << endl;
+  if (recordedLines.size() > 0)
+    cout << " -- " << mismatches << " regions differ from " << referencePath << endl;
+  else
+    cout << " -- Recorded corners to " << outputPath << ".  Copy it to " << referencePath << " to verify later runs" << endl;
+}
+
+void benchmarkSegmentation(string country, string inDir, vector<string> files)
+{
+  Config config(country);
+  config.debugOff();
+
+  Detector* plateDetector = createDetector(&config);
+
+  timespec startTime;
+  timespec endTime;
+  double totalTime = 0;
+  int totalAllocations = 0;
+  size_t totalHeapAllocations = 0;
+  int plateCount = 0;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str());
+
+      vector<PlateRegion> regions = plateDetector->detect(frame);
+
+      for (unsigned int z = 0; z < regions.size(); z++)
+      {
+        PipelineData pipeline_data(frame, regions[z].rect, &config);
+
+        size_t heapAllocationsBefore = getAllocationCount();
+        getTimeMonotonic(&startTime);
+        LicensePlateCandidate lp(&pipeline_data);
+        lp.recognize();
+        getTimeMonotonic(&endTime);
+        size_t heapAllocations = getAllocationCount() - heapAllocationsBefore;
+
+        // Only plates that made it through segmentation are counted
+        if (pipeline_data.disqualified)
+          continue;
+
+        totalTime += diffclock(startTime, endTime);
+        totalAllocations += pipeline_data.scratch.getAllocationCount();
+        totalHeapAllocations += heapAllocations;
+        plateCount++;
+      }
+    }
+  }
+
+  delete plateDetector;
+
+  cout << "Segmentation: " << plateCount << " plates, avg candidate analysis time: " << (plateCount > 0 ? totalTime / plateCount : 0) << "ms";
+  cout << endl;
+  cout << " -- Scratch arena buffers allocated per plate: " << (plateCount > 0 ? ((float) totalAllocations) / plateCount : 0)
+       << " (arena buffers only)" << endl;
+  cout << " -- Heap allocations per plate: " << (plateCount > 0 ? ((float) totalHeapAllocations) / plateCount : 0)
+       << " (operator new across the whole candidate analysis; cv::Mat buffers come from malloc and are not included)" << endl;
+}
+
+void benchmarkOcrBackends(string country, string inDir, vector<string> files)
+{
+  Config config(country);
+  config.debugOff();
+
+  Detector* plateDetector = createDetector(&config);
+  TesseractOcr tesseractOcr(&config);
+  GlyphOcr glyphOcr(&config);
+
+  if (glyphOcr.isLoaded() == false)
+  {
+    cout << "Unable to load the glyph classifier model " << config.getGlyphClassifierFile() << endl;
+    delete plateDetector;
+    return;
+  }
+
+  timespec startTime;
+  timespec endTime;
+  double tesseractTime = 0;
+  double glyphTime = 0;
+  int plateCount = 0;
+  int matchingPlates = 0;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str());
+
+      vector<PlateRegion> regions = plateDetector->detect(frame);
+
+      for (unsigned int z = 0; z < regions.size(); z++)
+      {
+        PipelineData pipeline_data(frame, regions[z].rect, &config);
+        LicensePlateCandidate lp(&pipeline_data);
+        lp.recognize();
+
+        if (pipeline_data.disqualified)
+          continue;
+
+        // performOCR inverts the thresholds, so each backend gets its own copy
+        vector<Mat> thresholds;
+        for (unsigned int t = 0; t < pipeline_data.thresholds.size(); t++)
+          thresholds.push_back(pipeline_data.thresholds[t].clone());
+
+        getTimeMonotonic(&startTime);
+        tesseractOcr.performOCR(&pipeline_data);
+        tesseractOcr.postProcessor.analyze("", 10);
+        getTimeMonotonic(&endTime);
+        tesseractTime += diffclock(startTime, endTime);
+
+        pipeline_data.thresholds = thresholds;
+
+        getTimeMonotonic(&startTime);
+        glyphOcr.performOCR(&pipeline_data);
+        glyphOcr.postProcessor.analyze("", 10);
+        getTimeMonotonic(&endTime);
+        glyphTime += diffclock(startTime, endTime);
+
+        plateCount++;
+        if (tesseractOcr.postProcessor.bestChars == glyphOcr.postProcessor.bestChars)
+          matchingPlates++;
+        else
+          cout << files[i] << " region " << z << ": tesseract '" << tesseractOcr.postProcessor.bestChars << "' glyph '" << glyphOcr.postProcessor.bestChars << "'" << endl;
+      }
+    }
+  }
+
+  delete plateDetector;
+
+  if (plateCount == 0)
+  {
+    cout << "No plates found" << endl;
+    return;
+  }
+
+  cout << "OCR backends: " << plateCount << " plates" << endl;
+  cout << " -- Tesseract avg OCR time: " << tesseractTime / plateCount << "ms" << endl;
+  cout << " -- Glyph classifier avg OCR time: " << glyphTime / plateCount << "ms" << endl;
+  cout << " -- Best plate matches Tesseract: " << matchingPlates << " of " << plateCount << endl;
+}
+
+struct ReferencePermutationCompare {
+  bool operator() (const pair<float,vector<int> > &a, const pair<float,vector<int> > &b)
+  {
+    return (a.first < b.first);
+  }
+};
+
+// The permutation search that PostProcess used previously, with a priority queue of letter index
+// vectors and the score standing in for a hash of each permutation.  Without templates, like the benchmark.
+static void referencePermutationSearch(const vector<vector<Letter> >& letters, Config* config, int topn, vector<string>& results)
+{
+  priority_queue<pair<float,vector<int> >, vector<pair<float,vector<int> > >, ReferencePermutationCompare> permutations;
+  set<float> permutationHashes;
+  set<string> resultLetters;
+
+  results.clear();
+
+  float totalscore = 0;
+  for (unsigned int i = 0; i < letters.size(); i++)
+  {
+    if (letters[i].size() > 0)
+      totalscore += letters[i][0].totalscore;
+  }
+  vector<int> v(letters.size());
+  permutations.push(make_pair(totalscore, v));
+
+  int consecutiveNonMatches = 0;
+  while (permutations.size() > 0)
+  {
+    pair<float, vector<int> > topPermutation = permutations.top();
+
+    string plate = "";
+    int plate_char_length = 0;
+    for (unsigned int i = 0; i < letters.size(); i++)
+    {
+      if (letters[i].size() == 0)
+        continue;
+
+      const Letter& letter = letters[i][topPermutation.second[i]];
+      if (letter.letter != SKIP_CHAR)
+      {
+        plate = plate + letter.letter;
+        plate_char_length += 1;
+      }
+    }
+
+    if (plate_char_length >= config->postProcessMinCharacters && plate_char_length <= config->postProcessMaxCharacters &&
+        resultLetters.find(plate) == resultLetters.end())
+    {
+      results.push_back(plate);
+      resultLetters.insert(plate);
+      consecutiveNonMatches = 0;
+    }
+    else
+    {
+      consecutiveNonMatches += 1;
+    }
+    permutations.pop();
+
+    if (results.size() >= topn || consecutiveNonMatches >= 10)
+      break;
+
+    for (unsigned int i = 0; i < letters.size(); i++)
+    {
+      if (topPermutation.second[i] + 1 >= letters[i].size())
+        continue;
+
+      pair<float, vector<int> > childPermutation = topPermutation;
+      childPermutation.first -= letters[i][topPermutation.second[i]].totalscore - letters[i][topPermutation.second[i] + 1].totalscore;
+      childPermutation.second[i] += 1;
+
+      if (permutationHashes.end() != permutationHashes.find(childPermutation.first))
+        continue;
+
+      permutations.push(childPermutation);
+      permutationHashes.insert(childPermutation.first);
+    }
+  }
+}
+
+void benchmarkPostProcess(string country, string inDir, vector<string> files)
+{
+  Config config(country);
+  config.debugOff();
+
+  Detector* plateDetector = createDetector(&config);
+  OCR* ocr = createOcr(&config);
+
+  const int topNs[] = {10, 25, 100};
+  const int topNCount = 3;
+  const int repetitions = 20;
+
+  vector<double> analyzeTimes(topNCount, 0);
+  vector<double> referenceTimes(topNCount, 0);
+  vector<size_t> analyzeAllocations(topNCount, 0);
+  vector<size_t> referenceAllocations(topNCount, 0);
+  vector<int> resultCounts(topNCount, 0);
+  vector<int> matchingTopNs(topNCount, 0);
+  int plateCount = 0;
+
+  timespec startTime;
+  timespec endTime;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str());
+
+      vector<PlateRegion> regions = plateDetector->detect(frame);
+
+      for (unsigned int z = 0; z < regions.size(); z++)
+      {
+        PipelineData pipeline_data(frame, regions[z].rect, &config);
+        LicensePlateCandidate lp(&pipeline_data);
+        lp.recognize();
+
+        if (pipeline_data.disqualified)
+          continue;
+
+        ocr->performOCR(&pipeline_data);
+        plateCount++;
+
+        for (int t = 0; t < topNCount; t++)
+        {
+          // The first analyze sorts the letters and sizes the search buffers for this plate
+          ocr->postProcessor.analyze("", topNs[t]);
+
+          size_t allocationsBefore = getAllocationCount();
+          getTimeMonotonic(&startTime);
+          for (int r = 0; r < repetitions; r++)
+            ocr->postProcessor.analyze("", topNs[t]);
+          getTimeMonotonic(&endTime);
+
+          analyzeAllocations[t] += getAllocationCount() - allocationsBefore;
+          analyzeTimes[t] += diffclock(startTime, endTime) / repetitions;
+
+          const vector<PPResult>& results = ocr->postProcessor.getResults();
+          resultCounts[t] += results.size();
+
+          vector<string> referenceResults;
+          allocationsBefore = getAllocationCount();
+          getTimeMonotonic(&startTime);
+          for (int r = 0; r < repetitions; r++)
+            referencePermutationSearch(ocr->postProcessor.getLetters(), &config, topNs[t], referenceResults);
+          getTimeMonotonic(&endTime);
+
+          referenceAllocations[t] += getAllocationCount() - allocationsBefore;
+          referenceTimes[t] += diffclock(startTime, endTime) / repetitions;
+
+          bool sameTopN = (results.size() == referenceResults.size());
+          for (unsigned int p = 0; sameTopN && p < results.size(); p++)
+            sameTopN = (results[p].letters == referenceResults[p]);
+
+          if (sameTopN)
+            matchingTopNs[t]++;
+        }
+      }
+    }
+  }
+
+  delete ocr;
+  delete plateDetector;
+
+  if (plateCount == 0)
+  {
+    cout << "No plates found" << endl;
+    return;
+  }
+
+  cout << "Post processing: " << plateCount << " plates" << endl;
+  for (int t = 0; t < topNCount; t++)
+  {
+    int analyzeCount = plateCount * repetitions;
+    cout << " -- topN " << topNs[t] << ": avg time " << analyzeTimes[t] / plateCount << "ms ("
+         << referenceTimes[t] / plateCount << "ms previously), avg " << ((float) resultCounts[t]) / plateCount << " results" << endl;
+    cout << "      heap allocations per search: " << ((float) analyzeAllocations[t]) / analyzeCount << " ("
+         << ((float) referenceAllocations[t]) / analyzeCount << " previously)" << endl;
+    cout << "      same top " << topNs[t] << " as the previous search: " << matchingTopNs[t] << " of " << plateCount
+         << " plates (it dropped permutations with equal scores)" << endl;
+  }
+}
+
+void benchmarkStateId(string country, string inDir, vector<string> files)
+{
+  Config bruteForceConfig(country);
+  bruteForceConfig.debugOff();
+  bruteForceConfig.stateIdDescriptorIndex = false;
+
+  Config indexConfig(country);
+  indexConfig.debugOff();
+  indexConfig.stateIdDescriptorIndex = true;
+
+  Detector* plateDetector = createDetector(&bruteForceConfig);
+
+  timespec startTime;
+  timespec endTime;
+
+  getTimeMonotonic(&startTime);
+  StateIdentifier bruteForceIdentifier(&bruteForceConfig);
+  getTimeMonotonic(&endTime);
+  double bruteForceLoadTime = diffclock(startTime, endTime);
+
+  getTimeMonotonic(&startTime);
+  StateIdentifier indexIdentifier(&indexConfig);
+  getTimeMonotonic(&endTime);
+  double indexLoadTime = diffclock(startTime, endTime);
+
+  double bruteForceTime = 0;
+  double indexTime = 0;
+  int plateCount = 0;
+  int bruteForceFound = 0;
+  int indexFound = 0;
+  int matchingRegions = 0;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str());
+
+      vector<PlateRegion> regions = plateDetector->detect(frame);
+
+      for (unsigned int z = 0; z < regions.size(); z++)
+      {
+        PipelineData bruteForceData(frame, regions[z].rect, &bruteForceConfig);
+        PipelineData indexData(frame, regions[z].rect, &indexConfig);
+
+        getTimeMonotonic(&startTime);
+        bool bruteForceResult = bruteForceIdentifier.recognize(&bruteForceData);
+        getTimeMonotonic(&endTime);
+        bruteForceTime += diffclock(startTime, endTime);
+
+        getTimeMonotonic(&startTime);
+        bool indexResult = indexIdentifier.recognize(&indexData);
+        getTimeMonotonic(&endTime);
+        indexTime += diffclock(startTime, endTime);
+
+        string bruteForceRegion = bruteForceResult ? bruteForceData.region_code : "";
+        string indexRegion = indexResult ? indexData.region_code : "";
+
+        plateCount++;
+        if (bruteForceResult)
+          bruteForceFound++;
+        if (indexResult)
+          indexFound++;
+
+        if (bruteForceRegion == indexRegion)
+          matchingRegions++;
+        else
+          cout << files[i] << " region " << z << ": brute force '" << bruteForceRegion << "' index '" << indexRegion << "'" << endl;
+      }
+    }
+  }
+
+  delete plateDetector;
+
+  cout << "State identification: " << plateCount << " plates" << endl;
+  cout << " -- Brute force: load " << bruteForceLoadTime << "ms, " << bruteForceFound << " regions found";
+  if (plateCount > 0)
+    cout << ", avg time " << bruteForceTime / plateCount << "ms";
+  cout << endl;
+  cout << " -- Descriptor index: load " << indexLoadTime << "ms, " << indexFound << " regions found";
+  if (plateCount > 0)
+    cout << ", avg time " << indexTime / plateCount << "ms";
+  cout << endl;
+  cout << " -- Same region as brute force: " << matchingRegions << " of " << plateCount << endl;
+}
+
+// Reference copy of the cJSON based AlprImpl::toJson
+static cJSON* referencePlateJson(const AlprPlateResult* result)
+{
+  cJSON *root, *coords, *candidates;
+
+  root=cJSON_CreateObject();
+
+  cJSON_AddStringToObject(root,"plate",		result->bestPlate.characters.c_str());
+  cJSON_AddNumberToObject(root,"confidence",		result->bestPlate.overall_confidence);
+  cJSON_AddNumberToObject(root,"matches_template",	result->bestPlate.matches_template);
+
+  cJSON_AddNumberToObject(root,"plate_index",               result->plate_index);
+
+  cJSON_AddStringToObject(root,"region",		result->region.c_str());
+  cJSON_AddNumberToObject(root,"region_confidence",	result->regionConfidence);
+
+  cJSON_AddNumberToObject(root,"processing_time_ms",	result->processing_time_ms);
+  cJSON_AddNumberToObject(root,"requested_topn",	result->requested_topn);
+
+  cJSON_AddItemToObject(root, "coordinates", 		coords=cJSON_CreateArray());
+  for (int i=0;i<4;i++)
+  {
+    cJSON *coords_object;
+    coords_object = cJSON_CreateObject();
+    cJSON_AddNumberToObject(coords_object, "x",  result->plate_points[i].x);
+    cJSON_AddNumberToObject(coords_object, "y",  result->plate_points[i].y);
+
+    cJSON_AddItemToArray(coords, coords_object);
+  }
+
+  cJSON_AddItemToObject(root, "candidates", 		candidates=cJSON_CreateArray());
+  for (unsigned int i = 0; i < result->topNPlates.size(); i++)
+  {
+    cJSON *candidate_object;
+    candidate_object = cJSON_CreateObject();
+    cJSON_AddStringToObject(candidate_object, "plate",  result->topNPlates[i].characters.c_str());
+    cJSON_AddNumberToObject(candidate_object, "confidence",  result->topNPlates[i].overall_confidence);
+    cJSON_AddNumberToObject(candidate_object, "matches_template",  result->topNPlates[i].matches_template);
+
+    cJSON_AddItemToArray(candidates, candidate_object);
+  }
+
+  return root;
+}
+
+static string referenceToJson(const AlprResults& results)
+{
+  cJSON *root, *jsonResults;
+  root = cJSON_CreateObject();
+
+  cJSON_AddNumberToObject(root,"version",	2	  );
+  cJSON_AddStringToObject(root,"data_type",	"alpr_results"	  );
+
+  cJSON_AddNumberToObject(root,"epoch_time",	results.epoch_time	  );
+  cJSON_AddNumberToObject(root,"img_width",	results.img_width	  );
+  cJSON_AddNumberToObject(root,"img_height",	results.img_height	  );
+  cJSON_AddNumberToObject(root,"processing_time_ms", results.total_processing_time_ms );
+
+  cJSON *rois;
+  cJSON_AddItemToObject(root, "regions_of_interest", 		rois=cJSON_CreateArray());
+  for (unsigned int i=0;i<results.regionsOfInterest.size();i++)
+  {
+    cJSON *roi_object;
+    roi_object = cJSON_CreateObject();
+    cJSON_AddNumberToObject(roi_object, "x",  results.regionsOfInterest[i].x);
+    cJSON_AddNumberToObject(roi_object, "y",  results.regionsOfInterest[i].y);
+    cJSON_AddNumberToObject(roi_object, "width",  results.regionsOfInterest[i].width);
+    cJSON_AddNumberToObject(roi_object, "height",  results.regionsOfInterest[i].height);
+
+    cJSON_AddItemToArray(rois, roi_object);
+  }
+
+  cJSON_AddItemToObject(root, "results", 		jsonResults=cJSON_CreateArray());
+  for (unsigned int i = 0; i < results.plates.size(); i++)
+  {
+    cJSON *resultObj = referencePlateJson( &results.plates[i] );
+    cJSON_AddItemToArray(jsonResults, resultObj);
+  }
+
+  char *out;
+  out=cJSON_PrintUnformatted(root);
+
+  cJSON_Delete(root);
+
+  string response(out);
+
+  free(out);
+  return response;
+}
+
+// Results shaped like real ones, with a fixed seed so every run serializes the same data
+static AlprResults generateResults(int plateCount, int topN)
+{
+  RNG rng(12345);
+  const string letters = "ABCDEFGHJKLMNPRSTUVWXYZ0123456789";
+
+  AlprResults results;
+  results.epoch_time = getEpochTimeMs();
+  results.img_width = 1280;
+  results.img_height = 720;
+  results.total_processing_time_ms = rng.uniform(50.0f, 500.0f);
+  results.regionsOfInterest.push_back(AlprRegionOfInterest(0, 0, 1280, 720));
+
+  for (int p = 0; p < plateCount; p++)
+  {
+    AlprPlateResult plate;
+    plate.requested_topn = topN;
+    plate.processing_time_ms = rng.uniform(5.0f, 80.0f);
+    plate.plate_index = p;
+    plate.region = p % 3 == 0 ? "ca" : "";
+    plate.regionConfidence = p % 3 == 0 ? rng.uniform(0, 100) : 0;
+
+    for (int c = 0; c < 4; c++)
+    {
+      plate.plate_points[c].x = rng.uniform(0, 1280);
+      plate.plate_points[c].y = rng.uniform(0, 720);
+    }
+
+    for (int n = 0; n < topN; n++)
+    {
+      AlprPlate candidate;
+      for (int l = 0; l < 7; l++)
+        candidate.characters.push_back(letters[rng.uniform(0, (int) letters.size())]);
+      candidate.overall_confidence = rng.uniform(60.0f, 95.0f);
+      candidate.matches_template = rng.uniform(0, 2) == 1;
+      plate.topNPlates.push_back(candidate);
+    }
+    plate.bestPlate = plate.topNPlates[0];
+
+    results.plates.push_back(plate);
+  }
+
+  return results;
+}
+
+void benchmarkJsonSerialization()
+{
+  const int plateCounts[] = {1, 10, 50};
+  const int topN = 25;
+
+  for (int i = 0; i < 3; i++)
+  {
+    AlprResults results = generateResults(plateCounts[i], topN);
+    int iterations = 5000 / plateCounts[i];
+
+    string referenceJson = referenceToJson(results);
+    string json = Alpr::toJson(results);
+
+    timespec startTime;
+    timespec endTime;
+
+    getTimeMonotonic(&startTime);
+    for (int n = 0; n < iterations; n++)
+      referenceJson = referenceToJson(results);
+    getTimeMonotonic(&endTime);
+    double referenceTime = diffclock(startTime, endTime) / iterations;
+
+    getTimeMonotonic(&startTime);
+    for (int n = 0; n < iterations; n++)
+      json = Alpr::toJson(results);
+    getTimeMonotonic(&endTime);
+    double writerTime = diffclock(startTime, endTime) / iterations;
+
+    cout << "JSON serialization: " << plateCounts[i] << " plates, topN " << topN << ", " << json.size() << " bytes" << endl;
+    cout << " -- cJSON tree: " << referenceTime << "ms" << endl;
+    cout << " -- JSON writer: " << writerTime << "ms" << endl;
+    cout << " -- Output identical: " << (json == referenceJson ? "yes" : "NO") << endl;
+  }
+}
+
+// Reference copy of the cJSON based AlprImpl::fromJson
+static AlprResults referenceFromJson(string json)
+{
+  AlprResults allResults;
+
+  cJSON* root = cJSON_Parse(json.c_str());
+
+  allResults.epoch_time = (int64_t) cJSON_GetObjectItem(root, "epoch_time")->valuedouble;
+  allResults.img_width = cJSON_GetObjectItem(root, "img_width")->valueint;
+  allResults.img_height = cJSON_GetObjectItem(root, "img_height")->valueint;
+  allResults.total_processing_time_ms = cJSON_GetObjectItem(root, "processing_time_ms")->valueint;
+
+  cJSON* rois = cJSON_GetObjectItem(root,"regions_of_interest");
+  int numRois = cJSON_GetArraySize(rois);
+  for (int c = 0; c < numRois; c++)
+  {
+    cJSON* roi = cJSON_GetArrayItem(rois, c);
+    int x = cJSON_GetObjectItem(roi, "x")->valueint;
+    int y = cJSON_GetObjectItem(roi, "y")->valueint;
+    int width = cJSON_GetObjectItem(roi, "width")->valueint;
+    int height = cJSON_GetObjectItem(roi, "height")->valueint;
+
+    allResults.regionsOfInterest.push_back(AlprRegionOfInterest(x,y,width,height));
+  }
+
+  cJSON* resultsArray = cJSON_GetObjectItem(root,"results");
+  int resultsSize = cJSON_GetArraySize(resultsArray);
+
+  for (int i = 0; i < resultsSize; i++)
+  {
+    cJSON* item = cJSON_GetArrayItem(resultsArray, i);
+    AlprPlateResult plate;
+
+    plate.processing_time_ms = cJSON_GetObjectItem(item, "processing_time_ms")->valuedouble;
+    plate.plate_index = cJSON_GetObjectItem(item, "plate_index")->valueint;
+    plate.region = string(cJSON_GetObjectItem(item, "region")->valuestring);
+    plate.regionConfidence = cJSON_GetObjectItem(item, "region_confidence")->valueint;
+    plate.requested_topn = cJSON_GetObjectItem(item, "requested_topn")->valueint;
+
+    cJSON* coordinates = cJSON_GetObjectItem(item,"coordinates");
+    for (int c = 0; c < 4; c++)
+    {
+      cJSON* coordinate = cJSON_GetArrayItem(coordinates, c);
+      plate.plate_points[c].x = cJSON_GetObjectItem(coordinate, "x")->valueint;
+      plate.plate_points[c].y = cJSON_GetObjectItem(coordinate, "y")->valueint;
+    }
+
+    cJSON* candidates = cJSON_GetObjectItem(item,"candidates");
+    int numCandidates = cJSON_GetArraySize(candidates);
+    for (int c = 0; c < numCandidates; c++)
+    {
+      cJSON* candidate = cJSON_GetArrayItem(candidates, c);
+      AlprPlate plateCandidate;
+      plateCandidate.characters = string(cJSON_GetObjectItem(candidate, "plate")->valuestring);
+      plateCandidate.overall_confidence = cJSON_GetObjectItem(candidate, "confidence")->valuedouble;
+      plateCandidate.matches_template = (cJSON_GetObjectItem(candidate, "matches_template")->valueint) != 0;
+
+      plate.topNPlates.push_back(plateCandidate);
+
+      if (c == 0)
+        plate.bestPlate = plateCandidate;
+    }
+
+    allResults.plates.push_back(plate);
+  }
+
+  cJSON_Delete(root);
+
+  return allResults;
+}
+
+void benchmarkJsonParsing()
+{
+  const int plateCounts[] = {10, 50, 200};
+  const int topN = 25;
+
+  for (int i = 0; i < 3; i++)
+  {
+    AlprResults results = generateResults(plateCounts[i], topN);
+    string json = Alpr::toJson(results);
+    int iterations = 5000 / plateCounts[i];
+
+    timespec startTime;
+    timespec endTime;
+
+    AlprResults referenceResults;
+    getTimeMonotonic(&startTime);
+    for (int n = 0; n < iterations; n++)
+      referenceResults = referenceFromJson(json);
+    getTimeMonotonic(&endTime);
+    double referenceTime = diffclock(startTime, endTime) / iterations;
+
+    AlprResults parsedResults;
+    string error;
+    bool valid = true;
+    getTimeMonotonic(&startTime);
+    for (int n = 0; n < iterations; n++)
+      valid = Alpr::fromJson(json, parsedResults, error) && valid;
+    getTimeMonotonic(&endTime);
+    double readerTime = diffclock(startTime, endTime) / iterations;
+
+    // Both read the same plates and candidates
+    bool identical = valid && parsedResults.plates.size() == referenceResults.plates.size();
+    for (unsigned int p = 0; identical && p < parsedResults.plates.size(); p++)
+    {
+      const AlprPlateResult& parsed = parsedResults.plates[p];
+      const AlprPlateResult& reference = referenceResults.plates[p];
+      identical = parsed.topNPlates.size() == reference.topNPlates.size() && parsed.region == reference.region &&
+                  parsed.plate_points[2].x == reference.plate_points[2].x;
+      for (unsigned int c = 0; identical && c < parsed.topNPlates.size(); c++)
+        identical = parsed.topNPlates[c].characters == reference.topNPlates[c].characters &&
+                    parsed.topNPlates[c].overall_confidence == reference.topNPlates[c].overall_confidence;
+    }
+
+    cout << "JSON parsing: " << plateCounts[i] << " plates, topN " << topN << ", " << json.size() << " bytes" << endl;
+    cout << " -- cJSON tree: " << referenceTime << "ms" << endl;
+    cout << " -- Pull parser: " << readerTime << "ms";
+    if (!valid)
+      cout << " (" << error << ")";
+    cout << endl;
+    cout << " -- Same results: " << (identical ? "yes" : "NO") << endl;
+  }
+}
+
+// Reference copy of AlprImpl's transform from the deskewed crop back to the original image
+static Mat referenceCharacterTransformMatrix(PipelineData* pipeline_data)
+{
+  vector<Point2f> crop_corners;
+  crop_corners.push_back(Point2f(0,0));
+  crop_corners.push_back(Point2f(pipeline_data->crop_gray.cols,0));
+  crop_corners.push_back(Point2f(pipeline_data->crop_gray.cols,pipeline_data->crop_gray.rows));
+  crop_corners.push_back(Point2f(0,pipeline_data->crop_gray.rows));
+
+  return getPerspectiveTransform(crop_corners, pipeline_data->plate_corners);
+}
+
+// Reference copy of the corners of one character that AlprImpl computed for each character of each candidate
+static vector<AlprCoordinate> referenceCharacterPoints(PreWarp* prewarp, Rect char_rect, Mat transmtx)
+{
+  vector<Point2f> points;
+  points.push_back(Point2f(char_rect.x, char_rect.y));
+  points.push_back(Point2f(char_rect.x + char_rect.width, char_rect.y));
+  points.push_back(Point2f(char_rect.x + char_rect.width, char_rect.y + char_rect.height));
+  points.push_back(Point2f(char_rect.x, char_rect.y + char_rect.height));
+
+  perspectiveTransform(points, points, transmtx);
+  points = prewarp->projectPoints(points, true);
+
+  vector<AlprCoordinate> cornersvector;
+  for (int i = 0; i < 4; i++)
+  {
+    AlprCoordinate coord;
+    coord.x = round(points[i].x);
+    coord.y = round(points[i].y);
+    cornersvector.push_back(coord);
+  }
+
+  return cornersvector;
+}
+
+// Reference copy of the result assembly in AlprImpl::recognizeFullDetails.  It copied the post processor's
+// results, built each candidate and character in a temporary, copied the best plate twice and copied the
+// plate result into the results.
+static void referenceAddPlateResult(PreWarp* prewarp, OCR* ocr, PipelineData* pipeline_data, AlprResults& results)
+{
+  AlprPlateResult plateResult;
+  plateResult.region = "";
+  plateResult.regionConfidence = 0;
+  plateResult.plate_index = 0;
+  plateResult.processing_time_ms = 0;
+
+  const vector<PPResult> ppResults = ocr->postProcessor.getResults();
+
+  int bestPlateIndex = 0;
+
+  cv::Mat charTransformMatrix = referenceCharacterTransformMatrix(pipeline_data);
+  for (unsigned int pp = 0; pp < ppResults.size(); pp++)
+  {
+    if (bestPlateIndex == 0 && ppResults[pp].matchesTemplate)
+      bestPlateIndex = plateResult.topNPlates.size();
+
+    AlprPlate aplate;
+    aplate.characters = ppResults[pp].letters;
+    aplate.overall_confidence = ppResults[pp].totalscore;
+    aplate.matches_template = ppResults[pp].matchesTemplate;
+
+    for (unsigned int c_idx = 0; c_idx < ppResults[pp].letter_details.size(); c_idx++)
+    {
+      AlprChar character_details;
+      character_details.character = ppResults[pp].letter_details[c_idx].letter;
+      character_details.confidence = ppResults[pp].letter_details[c_idx].totalscore;
+      cv::Rect char_rect = pipeline_data->charRegions[ppResults[pp].letter_details[c_idx].charposition];
+      std::vector<AlprCoordinate> charpoints = referenceCharacterPoints(prewarp, char_rect, charTransformMatrix );
+      for (int cpt = 0; cpt < 4; cpt++)
+        character_details.corners[cpt] = charpoints[cpt];
+      aplate.character_details.push_back(character_details);
+    }
+    plateResult.topNPlates.push_back(aplate);
+  }
+
+  if (plateResult.topNPlates.size() > bestPlateIndex)
+  {
+    AlprPlate bestPlate;
+    bestPlate.characters = plateResult.topNPlates[bestPlateIndex].characters;
+    bestPlate.matches_template = plateResult.topNPlates[bestPlateIndex].matches_template;
+    bestPlate.overall_confidence = plateResult.topNPlates[bestPlateIndex].overall_confidence;
+    bestPlate.character_details = plateResult.topNPlates[bestPlateIndex].character_details;
+
+    plateResult.bestPlate = bestPlate;
+  }
+
+  results.plates.push_back(plateResult);
+}
+
+static void clearResults(AlprResults& results)
+{
+  results.epoch_time = 0;
+  results.img_width = 0;
+  results.img_height = 0;
+  results.total_processing_time_ms = 0;
+  results.plates.clear();
+}
+
+// Assembles the plate the way AlprImpl::recognizeFullDetails does and hands the results back the way
+// recognize() does
+static void addPlateResult(AlprImpl& impl, OCR* ocr, PipelineData* pipeline_data, AlprResults& results)
+{
+  AlprResults fullResults;
+  clearResults(fullResults);
+
+  AlprPlateResult plateResult;
+  plateResult.region = "";
+  plateResult.regionConfidence = 0;
+  plateResult.plate_index = 0;
+  plateResult.processing_time_ms = 0;
+  impl.addPlateCandidates(ocr->postProcessor.getResults(), pipeline_data, plateResult);
+
+  fullResults.plates.resize(1);
+  fullResults.plates.back().swap(plateResult);
+
+  results.swap(fullResults);
+}
+
+void benchmarkResultAssembly(string country, string inDir, vector<string> files)
+{
+  AlprImpl impl(country);
+  impl.config->debugOff();
+
+  Detector* plateDetector = createDetector(impl.config);
+  OCR* ocr = createOcr(impl.config);
+  PreWarp prewarp(impl.config);
+
+  const int topN = 25;
+  const int repetitions = 20;
+
+  double referenceTime = 0;
+  double assemblyTime = 0;
+  size_t referenceAllocations = 0;
+  size_t assemblyAllocations = 0;
+  double noDetailsTime = 0;
+  size_t noDetailsAllocations = 0;
+  int plateCount = 0;
+
+  timespec startTime;
+  timespec endTime;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str());
+
+      vector<PlateRegion> regions = plateDetector->detect(frame);
+
+      for (unsigned int z = 0; z < regions.size(); z++)
+      {
+        PipelineData pipeline_data(frame, regions[z].rect, impl.config);
+        LicensePlateCandidate lp(&pipeline_data);
+        lp.recognize();
+
+        if (pipeline_data.disqualified)
+          continue;
+
+        ocr->performOCR(&pipeline_data);
+        ocr->postProcessor.analyze("", topN);
+        if (ocr->postProcessor.getResults().size() == 0)
+          continue;
+
+        plateCount++;
+
+        // Each repetition assembles the plate and hands the results back the way recognize() does
+        size_t allocationsBefore = getAllocationCount();
+        getTimeMonotonic(&startTime);
+        for (int r = 0; r < repetitions; r++)
+        {
+          AlprResults fullResults;
+          clearResults(fullResults);
+          referenceAddPlateResult(&prewarp, ocr, &pipeline_data, fullResults);
+
+          AlprResults results = fullResults;
+        }
+        getTimeMonotonic(&endTime);
+        referenceTime += diffclock(startTime, endTime) / repetitions;
+        referenceAllocations += getAllocationCount() - allocationsBefore;
+
+        allocationsBefore = getAllocationCount();
+        getTimeMonotonic(&startTime);
+        for (int r = 0; r < repetitions; r++)
+        {
+          AlprResults results;
+          addPlateResult(impl, ocr, &pipeline_data, results);
+        }
+        getTimeMonotonic(&endTime);
+        assemblyTime += diffclock(startTime, endTime) / repetitions;
+        assemblyAllocations += getAllocationCount() - allocationsBefore;
+
+        impl.setIncludeCharacterDetails(false);
+        allocationsBefore = getAllocationCount();
+        getTimeMonotonic(&startTime);
+        for (int r = 0; r < repetitions; r++)
+        {
+          AlprResults results;
+          addPlateResult(impl, ocr, &pipeline_data, results);
+        }
+        getTimeMonotonic(&endTime);
+        noDetailsTime += diffclock(startTime, endTime) / repetitions;
+        noDetailsAllocations += getAllocationCount() - allocationsBefore;
+        impl.setIncludeCharacterDetails(true);
+      }
+    }
+  }
+
+  delete ocr;
+  delete plateDetector;
+
+  if (plateCount == 0)
+  {
+    cout << "No plates found" << endl;
+    return;
+  }
+
+  int resultCount = plateCount * repetitions;
+  cout << "Result assembly: " << plateCount << " plates, topN " << topN << endl;
+  cout << " -- Copying: avg time " << referenceTime / plateCount << "ms, "
+       << ((float) referenceAllocations) / resultCount << " allocations per result" << endl;
+  cout << " -- In place: avg time " << assemblyTime / plateCount << "ms, "
+       << ((float) assemblyAllocations) / resultCount << " allocations per result" << endl;
+  cout << " -- In place, without character details: avg time " << noDetailsTime / plateCount << "ms, "
+       << ((float) noDetailsAllocations) / resultCount << " allocations per result" << endl;
+}
+
+void benchmarkSteadyState(string country, string inDir, vector<string> files)
+{
+  AlprImpl impl(country);
+  impl.config->debugOff();
+
+  const int framesPerVideo = 10;
+
+  double warmupTime = 0;
+  double steadyTime = 0;
+  size_t warmupAllocations = 0;
+  size_t steadyAllocations = 0;
+  int warmupBuffers = 0;
+  int steadyBuffers = 0;
+  int videoCount = 0;
+
+  timespec startTime;
+  timespec endTime;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") || hasEnding(files[i], ".jpg"))
+    {
+      string fullpath = inDir + "/" + files[i];
+      Mat frame = imread(fullpath.c_str());
+
+      // Each image starts a new video, with a frame context that hasn't seen its size
+      videoCount++;
+      for (int f = 0; f < framesPerVideo; f++)
+      {
+        impl.getFrameContext()->resetAllocationCount();
+        size_t allocationsBefore = getAllocationCount();
+        getTimeMonotonic(&startTime);
+
+        AlprResults results = impl.recognize(frame);
+
+        getTimeMonotonic(&endTime);
+        size_t allocations = getAllocationCount() - allocationsBefore;
+        int buffers = impl.getFrameContext()->getAllocationCount();
+
+        if (f == 0)
+        {
+          warmupTime += diffclock(startTime, endTime);
+          warmupAllocations += allocations;
+          warmupBuffers += buffers;
+        }
+        else
+        {
+          steadyTime += diffclock(startTime, endTime);
+          steadyAllocations += allocations;
+          steadyBuffers += buffers;
+        }
+      }
+    }
+  }
+
+  if (videoCount == 0)
+  {
+    cout << "No images found" << endl;
+    return;
+  }
+
+  int steadyFrames = videoCount * (framesPerVideo - 1);
+  cout << "Steady state: " << videoCount << " videos of " << framesPerVideo << " frames" << endl;
+  cout << " -- First frame: avg time " << warmupTime / videoCount << "ms, "
+       << ((float) warmupAllocations) / videoCount << " heap allocations, "
+       << ((float) warmupBuffers) / videoCount << " buffer allocations" << endl;
+  cout << " -- Later frames: avg time " << steadyTime / steadyFrames << "ms, "
+       << ((float) steadyAllocations) / steadyFrames << " heap allocations, "
+       << ((float) steadyBuffers) / steadyFrames << " buffer allocations" << endl;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_MICROBENCHMARKS_H
+#define OPENALPR_MICROBENCHMARKS_H
+
+#include <string>
+#include <vector>
+
+// Micro-benchmarks for individual pipeline stages.  Each one compares the current
+// implementation against a reference copy of the code it replaced.
+
+// Column counting in VerticalHistogram on ocrImageWidthPx x ocrImageHeightPx crops
+void benchmarkVerticalHistogram(std::string country, std::string inDir, std::vector<std::string> files);
+
+// Plate corner detection timing.  Writes the corners found for every detected region to
+// [outDir]/platecorners.txt and, if [outDir]/platecorners_reference.txt exists (a copy of a
+// previous run), reports every region whose corners differ from the recorded corpus.
+void benchmarkPlateCorners(std::string country, std::string inDir, std::string outDir, std::vector<std::string> files);
+
+// Candidate analysis timing for each plate that survives segmentation.  Reports the scratch arena
+// buffers allocated per plate, and separately every heap allocation made by operator new during the analysis
+void benchmarkSegmentation(std::string country, std::string inDir, std::vector<std::string> files);
+
+// OCR time of the Tesseract and glyph classifier backends on the same plates, and how often
+// the glyph classifier's best plate agrees with Tesseract
+void benchmarkOcrBackends(std::string country, std::string inDir, std::vector<std::string> files);
+
+// Post processing time and heap allocations of the permutation search at topN 10, 25 and 100, run
+// repeatedly on the letters OCR found for each plate, and compared with the previous search
+void benchmarkPostProcess(std::string country, std::string inDir, std::vector<std::string> files);
+
+// State identification time with brute force descriptor matching and with the descriptor index,
+// and how often the index finds the same region as brute force
+void benchmarkStateId(std::string country, std::string inDir, std::vector<std::string> files);
+
+// Alpr::toJson against the previous cJSON tree serialization, on generated results with 1, 10 and 50
+// plates of 25 candidates each.  Also checks that both produce the same bytes.
+void benchmarkJsonSerialization();
+
+// Alpr::fromJson against the previous cJSON tree parsing, on the JSON of generated results with 10, 50
+// and 200 plates of 25 candidates each.  Also checks that both read the same plates.
+void benchmarkJsonParsing();
+
+// Time and heap allocations to turn the post processor's results for each plate into an AlprPlateResult
+// and hand the AlprResults back, with the previous copying assembly, the in-place one, and the in-place one
+// with character details turned off
+void benchmarkResultAssembly(std::string country, std::string inDir, std::vector<std::string> files);
+
+// Recognizes each image repeatedly, like the frames of a fixed size video.  Reports the time, heap
+// allocations and recycled buffer allocations of the first frame against the average of the frames after it.
+void benchmarkSteadyState(std::string country, std::string inDir, std::vector<std::string> files);
+
+#endif // OPENALPR_MICROBENCHMARKS_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <stdio.h>
+#include "../tclap/CmdLine.h"
+#include "config.h"
+#include "featurematcher.h"
+
+using namespace std;
+using namespace cv;
+using namespace alpr;
+
+// Extracts the keypoints of a country's training plates (runtime_data/keypoints/[country]/) and writes
+// the keypoint cache that the state identifier loads at startup.  The state identifier also rebuilds the
+// cache itself when it is stale, provided the runtime data directory is writable.
+int main( int argc, const char** argv )
+{
+  string country;
+  string configFile;
+
+  TCLAP::CmdLine cmd("OpenAlpr Keypoint Cache Utility", ' ', "1.0.0");
+
+  TCLAP::ValueArg<std::string> countryCodeArg("c","country","Country code of the training plates.  Default=us",false, "us" ,"country_code");
+  TCLAP::ValueArg<std::string> configFileArg("","config","Path to the openalpr.conf file",false, "" ,"config_file");
+
+  try
+  {
+    cmd.add( countryCodeArg );
+    cmd.add( configFileArg );
+
+    if (cmd.parse( argc, argv ) == false)
+    {
+      // Error occured while parsing.  Exit now.
+      return 1;
+    }
+
+    country = countryCodeArg.getValue();
+    configFile = configFileArg.getValue();
+  }
+  catch (TCLAP::ArgException &e)    // catch any exceptions
+  {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+    return 1;
+  }
+
+  Config config(country, configFile);
+  FeatureMatcher featureMatcher(&config);
+
+  if (featureMatcher.writeRecognitionCache(country) == false)
+  {
+    cout << "Unable to write " << featureMatcher.getRecognitionCacheFile(country) << endl;
+    return 1;
+  }
+
+  // Read it back the way the state identifier does
+  featureMatcher.loadRecognitionSet(country);
+  cout << "Wrote " << featureMatcher.numTrainingElements() << " training plates to " << featureMatcher.getRecognitionCacheFile(country) << endl;
+
+  return 0;
+}
@@ -30,6 +30,7 @@
 #include "utility.h"
 #include "support/filesystem.h"
 #include "ocr.h"
+#include "ocr/ocrfactory.h"
 
 using namespace std;
 using namespace cv;
@@ -111,7 +112,7 @@ int main( int argc, const char** argv )
   config.debugGeneral = true;
   config.debugCharAnalysis = true;
   config.debugCharSegmenter = true;
-  OCR ocr(&config);
+  OCR* ocr = createOcr(&config);
 
   if (DirectoryExists(inDir.c_str()))
   {
@@ -150,9 +151,9 @@ int main( int argc, const char** argv )
 
         //ocr.cleanCharRegions(charSegmenter.thresholds, charSegmenter.characters);
 
-        ocr.performOCR(&pipeline_data);
-        ocr.postProcessor.analyze(statecodestr, 25);
-        cout << "OCR results: " << ocr.postProcessor.bestChars << endl;
+        ocr->performOCR(&pipeline_data);
+        ocr->postProcessor.analyze(statecodestr, 25);
+        cout << "OCR results: " << ocr->postProcessor.bestChars << endl;
 
         vector<bool> selectedBoxes(pipeline_data.thresholds.size());
         for (int z = 0; z < pipeline_data.thresholds.size(); z++)
@@ -283,6 +284,8 @@ int main( int argc, const char** argv )
       }
     }
   }
+
+  delete ocr;
 }
 
 void showDashboard(vector<Mat> images, vector<bool> selectedImages, int selectedIndex)
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "opencv2/highgui/highgui.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdio.h>
+#include "support/filesystem.h"
+#include "../tclap/CmdLine.h"
+#include "ocr/glyphclassifier.h"
+
+using namespace std;
+using namespace cv;
+using namespace alpr;
+
+// Builds the model for the built-in glyph classifier (ocr_backend = glyph) from a directory of
+// single character images saved by openalpr-utils-classifychars.  Those are named [char]-[threshold]-[image]
+int main( int argc, const char** argv )
+{
+  string inDir;
+  string outFile;
+
+  TCLAP::CmdLine cmd("OpenAlpr Glyph Classifier Training Utility", ' ', "1.0.0");
+
+  TCLAP::UnlabeledValueArg<std::string>  inputDirArg( "input_dir", "Folder containing individual character images", true, "", "input_dir_path"  );
+  TCLAP::UnlabeledValueArg<std::string>  outputFileArg( "output_file", "Model file to write.  Install it as runtime_data/ocr/[ocr language].glyphs.yml", true, "", "output_file_path"  );
+
+  try
+  {
+    cmd.add( inputDirArg );
+    cmd.add( outputFileArg );
+
+    if (cmd.parse( argc, argv ) == false)
+    {
+      // Error occured while parsing.  Exit now.
+      return 1;
+    }
+
+    inDir = inputDirArg.getValue();
+    outFile = outputFileArg.getValue();
+  }
+  catch (TCLAP::ArgException &e)    // catch any exceptions
+  {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+    return 1;
+  }
+
+  if (DirectoryExists(inDir.c_str()) == false)
+  {
+    printf("Input dir does not exist\n");
+    return 1;
+  }
+
+  vector<string> files = getFilesInDir(inDir.c_str());
+  sort( files.begin(), files.end(), stringCompare );
+
+  GlyphClassifier classifier;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (hasEnding(files[i], ".png") == false && hasEnding(files[i], ".jpg") == false)
+      continue;
+
+    size_t separator = files[i].find('-');
+    if (separator == string::npos || separator == 0)
+    {
+      cout << "Skipping " << files[i] << ", the file name does not start with a character" << endl;
+      continue;
+    }
+
+    string fullpath = inDir + "/" + files[i];
+    Mat glyph = imread(fullpath.c_str(), CV_LOAD_IMAGE_GRAYSCALE);
+    if (glyph.empty())
+    {
+      cout << "Unable to read " << fullpath << endl;
+      continue;
+    }
+
+    classifier.addSample(files[i].substr(0, separator), glyph);
+  }
+
+  if (classifier.save(outFile) == false)
+  {
+    cout << "Unable to write " << outFile << endl;
+    return 1;
+  }
+
+  cout << "Wrote " << classifier.getSampleCount() << " glyph samples to " << outFile << endl;
+
+  return 0;
+}
@@ -19,6 +19,7 @@
 
 #include "alpr.h"
 #include "alpr_impl.h"
+#include "alpr_binary.h"
 
 namespace alpr
 {
@@ -49,7 +50,8 @@ namespace alpr
       ifs.seekg(0, std::ios::beg);
       ifs.read(&buffer[0], pos);
 
-      return this->recognize( buffer );
+      // Straight to the implementation, which takes the bytes by reference
+      return impl->recognize( buffer );
     }
     else
     {
@@ -78,10 +80,40 @@ namespace alpr
     return AlprImpl::toJson(results);
   }
 
+  std::string Alpr::toJson( AlprResults results, const std::vector<AlprJsonField>& extraFields )
+  {
+    return AlprImpl::toJson(results, extraFields);
+  }
+
   AlprResults Alpr::fromJson(std::string json) {
     return AlprImpl::fromJson(json);
   }
 
+  bool Alpr::fromJson(std::string json, AlprResults& results, std::string& error) {
+    return AlprImpl::fromJson(json, results, error);
+  }
+
+  std::string Alpr::toBinary( AlprResults results )
+  {
+    std::string data;
+    writeBinaryResults(results, data);
+    return data;
+  }
+
+  AlprResults Alpr::fromBinary(const std::string& data)
+  {
+    AlprResults results;
+    if (!readBinaryResults(data.data(), data.size(), results))
+    {
+      results.epoch_time = 0;
+      results.img_width = 0;
+      results.img_height = 0;
+      results.total_processing_time_ms = 0;
+    }
+
+    return results;
+  }
+
 
   void Alpr::setDetectRegion(bool detectRegion)
   {
@@ -98,6 +130,21 @@ namespace alpr
     impl->setDefaultRegion(region);
   }
 
+  void Alpr::setIncludeCharacterDetails(bool includeCharacterDetails)
+  {
+    impl->setIncludeCharacterDetails(includeCharacterDetails);
+  }
+
+  void Alpr::setGrayscaleOnly(bool grayscaleOnly)
+  {
+    impl->setGrayscaleOnly(grayscaleOnly);
+  }
+
+  bool Alpr::isGrayscaleOnly()
+  {
+    return impl->isGrayscaleOnly();
+  }
+
   bool Alpr::isLoaded()
   {
     return impl->isLoaded();
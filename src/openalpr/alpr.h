@@ -23,6 +23,7 @@
 #include <iostream>
 #include <vector>
 #include <fstream> 
+#include <algorithm>
 #include <stdint.h>
 
 namespace alpr
@@ -48,6 +49,14 @@ namespace alpr
 
     std::vector<AlprChar> character_details;
     bool matches_template;
+
+    void swap(AlprPlate& other)
+    {
+      characters.swap(other.characters);
+      std::swap(overall_confidence, other.overall_confidence);
+      character_details.swap(other.character_details);
+      std::swap(matches_template, other.matches_template);
+    }
   };
   
 
@@ -69,6 +78,30 @@ namespace alpr
     int height;
   };
 
+  // An extra top level field for Alpr::toJson, holding either a string or a number
+  class AlprJsonField
+  {
+  public:
+    AlprJsonField(std::string name, std::string value)
+    {
+      this->name = name;
+      this->is_number = false;
+      this->string_value = value;
+      this->number_value = 0;
+    }
+    AlprJsonField(std::string name, double value)
+    {
+      this->name = name;
+      this->is_number = true;
+      this->number_value = value;
+    }
+
+    std::string name;
+    bool is_number;
+    std::string string_value;
+    double number_value;
+  };
+
   class AlprPlateResult
   {
     public:
@@ -96,6 +129,20 @@ namespace alpr
       // When region detection is enabled, this returns the region.  Region detection is experimental
       int regionConfidence;
       std::string region;
+
+      // Exchanges the contents without copying the plates and their characters
+      void swap(AlprPlateResult& other)
+      {
+        std::swap(requested_topn, other.requested_topn);
+        bestPlate.swap(other.bestPlate);
+        topNPlates.swap(other.topNPlates);
+        std::swap(processing_time_ms, other.processing_time_ms);
+        for (int i = 0; i < 4; i++)
+          std::swap(plate_points[i], other.plate_points[i]);
+        std::swap(plate_index, other.plate_index);
+        std::swap(regionConfidence, other.regionConfidence);
+        region.swap(other.region);
+      }
   };
 
   class AlprResults
@@ -113,6 +160,16 @@ namespace alpr
 
       std::vector<AlprRegionOfInterest> regionsOfInterest;
 
+      // Exchanges the contents without copying the plates
+      void swap(AlprResults& other)
+      {
+        std::swap(epoch_time, other.epoch_time);
+        std::swap(img_width, other.img_width);
+        std::swap(img_height, other.img_height);
+        std::swap(total_processing_time_ms, other.total_processing_time_ms);
+        plates.swap(other.plates);
+        regionsOfInterest.swap(other.regionsOfInterest);
+      }
   };
 
 
@@ -128,18 +185,38 @@ namespace alpr
       void setTopN(int topN);
       void setDefaultRegion(std::string region);
 
+      // Whether each plate candidate lists its characters with their corners and confidences (on by
+      // default).  Turn it off when only the plate strings are needed.
+      void setIncludeCharacterDetails(bool includeCharacterDetails);
+
+      // Processes images as grayscale only (off by default, or set with grayscale_only in the config).
+      // Encoded images are decoded straight to a single channel and no colour image is kept.  Raw
+      // pixel data can be passed with 1 byte per pixel.
+      void setGrayscaleOnly(bool grayscaleOnly);
+      bool isGrayscaleOnly();
+
       // Recognize from an image on disk
       AlprResults recognize(std::string filepath);
 
       // Recognize from byte data representing an encoded image (e.g., BMP, PNG, JPG, GIF etc).
       AlprResults recognize(std::vector<char> imageBytes);
 
-      // Recognize from raw pixel data.  
+      // Recognize from raw pixel data.  Accepts 3 bytes per pixel (BGR) or 1 byte per pixel (gray).
       AlprResults recognize(unsigned char* pixelData, int bytesPerPixel, int imgWidth, int imgHeight, std::vector<AlprRegionOfInterest> regionsOfInterest);
 
 
       static std::string toJson(const AlprResults results);
+
+      // Same as toJson, followed by extra top level fields (e.g., metadata about the camera)
+      static std::string toJson(const AlprResults results, const std::vector<AlprJsonField>& extraFields);
       static AlprResults fromJson(std::string json);
+      // Returns false and describes the problem in error when the JSON is malformed or misses a required field
+      static bool fromJson(std::string json, AlprResults& results, std::string& error);
+
+      // Compact binary form of the results, see alpr_binary.h for the layout and a reader that doesn't copy
+      static std::string toBinary(const AlprResults results);
+      // Results with no plates and zero values when the data is not a valid message
+      static AlprResults fromBinary(const std::string& data);
 
       bool isLoaded();
 
@@ -0,0 +1,688 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "alpr_binary.h"
+
+#include <string.h>
+
+using namespace std;
+
+namespace alpr
+{
+
+  namespace
+  {
+    const char BINARY_MAGIC[4] = { 'A', 'L', 'P', 'R' };
+
+    // Byte offsets of the fixed size fields in the message and its records
+    const size_t VERSION_OFFSET = 4;
+    const size_t MESSAGE_LENGTH_OFFSET = 8;
+    const size_t HEADER_SIZE = 12;
+    const size_t EPOCH_TIME_OFFSET = 12;
+    const size_t IMG_WIDTH_OFFSET = 20;
+    const size_t IMG_HEIGHT_OFFSET = 24;
+    const size_t TOTAL_PROCESSING_TIME_OFFSET = 28;
+    const size_t ROI_COUNT_OFFSET = 32;
+    const size_t ROI_SIZE = 16;
+
+    const size_t CORNERS_SIZE = 4 * 8;
+
+    // Relative to the start of a plate, including its length
+    const size_t PLATE_REQUESTED_TOPN_OFFSET = 4;
+    const size_t PLATE_INDEX_OFFSET = 8;
+    const size_t PLATE_REGION_CONFIDENCE_OFFSET = 12;
+    const size_t PLATE_PROCESSING_TIME_OFFSET = 16;
+    const size_t PLATE_POINTS_OFFSET = 20;
+    const size_t PLATE_REGION_OFFSET = 52;
+    // Relative to the end of the region string
+    const size_t PLATE_BEST_INDEX_OFFSET = 0;
+    const size_t PLATE_CANDIDATE_COUNT_OFFSET = 4;
+    const size_t PLATE_CANDIDATES_OFFSET = 8;
+
+    // Relative to the start of a candidate, including its length
+    const size_t CANDIDATE_CHARACTERS_OFFSET = 4;
+    // Relative to the end of the characters string
+    const size_t CANDIDATE_CONFIDENCE_OFFSET = 0;
+    const size_t CANDIDATE_MATCHES_TEMPLATE_OFFSET = 4;
+    const size_t CANDIDATE_CHARACTER_COUNT_OFFSET = 5;
+    const size_t CANDIDATE_CHARACTERS_LIST_OFFSET = 9;
+
+    const size_t CHARACTER_CONFIDENCE_OFFSET = 32;
+    const size_t CHARACTER_STRING_OFFSET = 36;
+
+    const size_t BINARY_BASE_SIZE_ESTIMATE = 128;
+    const size_t BINARY_PLATE_SIZE_ESTIMATE = 1024;
+
+    void appendUint16(string& output, uint16_t value)
+    {
+      output.push_back((char) (value & 0xFF));
+      output.push_back((char) (value >> 8));
+    }
+
+    void appendUint32(string& output, uint32_t value)
+    {
+      output.push_back((char) (value & 0xFF));
+      output.push_back((char) ((value >> 8) & 0xFF));
+      output.push_back((char) ((value >> 16) & 0xFF));
+      output.push_back((char) (value >> 24));
+    }
+
+    void appendInt32(string& output, int32_t value)
+    {
+      appendUint32(output, (uint32_t) value);
+    }
+
+    void appendInt64(string& output, int64_t value)
+    {
+      appendUint32(output, (uint32_t) ((uint64_t) value & 0xFFFFFFFF));
+      appendUint32(output, (uint32_t) ((uint64_t) value >> 32));
+    }
+
+    void appendFloat(string& output, float value)
+    {
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      appendUint32(output, bits);
+    }
+
+    void appendString(string& output, const string& value)
+    {
+      appendUint32(output, (uint32_t) value.size());
+      output.append(value);
+    }
+
+    void appendCoordinate(string& output, const AlprCoordinate& coordinate)
+    {
+      appendInt32(output, coordinate.x);
+      appendInt32(output, coordinate.y);
+    }
+
+    // Fills in a length that was written as a placeholder
+    void patchUint32(string& output, size_t offset, uint32_t value)
+    {
+      output[offset] = (char) (value & 0xFF);
+      output[offset + 1] = (char) ((value >> 8) & 0xFF);
+      output[offset + 2] = (char) ((value >> 16) & 0xFF);
+      output[offset + 3] = (char) (value >> 24);
+    }
+
+    uint16_t readUint16(const char* data)
+    {
+      const unsigned char* bytes = (const unsigned char*) data;
+      return (uint16_t) (bytes[0] | (bytes[1] << 8));
+    }
+
+    uint32_t readUint32(const char* data)
+    {
+      const unsigned char* bytes = (const unsigned char*) data;
+      return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+    }
+
+    int32_t readInt32(const char* data)
+    {
+      return (int32_t) readUint32(data);
+    }
+
+    int64_t readInt64(const char* data)
+    {
+      return (int64_t) ((uint64_t) readUint32(data) | ((uint64_t) readUint32(data + 4) << 32));
+    }
+
+    float readFloat(const char* data)
+    {
+      uint32_t bits = readUint32(data);
+      float value;
+      memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    AlprCoordinate readCoordinate(const char* data)
+    {
+      AlprCoordinate coordinate;
+      coordinate.x = readInt32(data);
+      coordinate.y = readInt32(data + 4);
+      return coordinate;
+    }
+
+    AlprStringView readString(const char* data)
+    {
+      AlprStringView view;
+      view.length = readUint32(data);
+      view.data = data + 4;
+      return view;
+    }
+
+    bool samePlate(const AlprPlate& a, const AlprPlate& b)
+    {
+      if (a.characters != b.characters || a.overall_confidence != b.overall_confidence ||
+          a.matches_template != b.matches_template || a.character_details.size() != b.character_details.size())
+        return false;
+
+      for (unsigned int i = 0; i < a.character_details.size(); i++)
+      {
+        const AlprChar& charA = a.character_details[i];
+        const AlprChar& charB = b.character_details[i];
+        if (charA.character != charB.character || charA.confidence != charB.confidence)
+          return false;
+
+        for (int c = 0; c < 4; c++)
+        {
+          if (charA.corners[c].x != charB.corners[c].x || charA.corners[c].y != charB.corners[c].y)
+            return false;
+        }
+      }
+
+      return true;
+    }
+
+    void writeCandidate(string& output, const AlprPlate& plate)
+    {
+      size_t start = output.size();
+      appendUint32(output, 0);
+
+      appendString(output, plate.characters);
+      appendFloat(output, plate.overall_confidence);
+      output.push_back(plate.matches_template ? 1 : 0);
+
+      appendUint32(output, (uint32_t) plate.character_details.size());
+      for (unsigned int i = 0; i < plate.character_details.size(); i++)
+      {
+        const AlprChar& character = plate.character_details[i];
+        for (int c = 0; c < 4; c++)
+          appendCoordinate(output, character.corners[c]);
+        appendFloat(output, character.confidence);
+        appendString(output, character.character);
+      }
+
+      patchUint32(output, start, (uint32_t) (output.size() - start - 4));
+    }
+
+    void writePlate(string& output, const AlprPlateResult& plate)
+    {
+      size_t start = output.size();
+      appendUint32(output, 0);
+
+      appendInt32(output, plate.requested_topn);
+      appendInt32(output, plate.plate_index);
+      appendInt32(output, plate.regionConfidence);
+      appendFloat(output, plate.processing_time_ms);
+      for (int i = 0; i < 4; i++)
+        appendCoordinate(output, plate.plate_points[i]);
+      appendString(output, plate.region);
+
+      // The best plate is normally one of the candidates, so it is only stored once
+      int bestIndex = -1;
+      for (unsigned int i = 0; i < plate.topNPlates.size(); i++)
+      {
+        if (samePlate(plate.bestPlate, plate.topNPlates[i]))
+        {
+          bestIndex = i;
+          break;
+        }
+      }
+
+      appendInt32(output, bestIndex);
+      appendUint32(output, (uint32_t) plate.topNPlates.size());
+      for (unsigned int i = 0; i < plate.topNPlates.size(); i++)
+        writeCandidate(output, plate.topNPlates[i]);
+      if (bestIndex < 0)
+        writeCandidate(output, plate.bestPlate);
+
+      patchUint32(output, start, (uint32_t) (output.size() - start - 4));
+    }
+
+    // Bounds checked walk over a message, used to validate it before handing out views
+    class BinaryCursor
+    {
+      public:
+        BinaryCursor(const char* pos, const char* end)
+        {
+          this->pos = pos;
+          this->end = end;
+        }
+
+        bool skip(size_t bytes)
+        {
+          if (bytes > (size_t) (end - pos))
+            return false;
+          pos += bytes;
+          return true;
+        }
+
+        bool readUint32(uint32_t& value)
+        {
+          if (end - pos < 4)
+            return false;
+          value = alpr::readUint32(pos);
+          pos += 4;
+          return true;
+        }
+
+        bool skipString()
+        {
+          uint32_t length;
+          return readUint32(length) && skip(length);
+        }
+
+        // Steps over a record that starts with its length.  The record itself is returned in the cursor.
+        bool enterRecord(BinaryCursor& record)
+        {
+          uint32_t length;
+          if (!readUint32(length))
+            return false;
+
+          record = BinaryCursor(pos, pos);
+          if (!skip(length))
+            return false;
+          record.end = pos;
+          return true;
+        }
+
+        const char* pos;
+        const char* end;
+    };
+
+    bool validateCandidate(BinaryCursor& cursor)
+    {
+      BinaryCursor candidate(NULL, NULL);
+      uint32_t characterCount;
+      if (!cursor.enterRecord(candidate) || !candidate.skipString() ||
+          !candidate.skip(CANDIDATE_CHARACTER_COUNT_OFFSET) || !candidate.readUint32(characterCount))
+        return false;
+
+      for (uint32_t i = 0; i < characterCount; i++)
+      {
+        if (!candidate.skip(CHARACTER_STRING_OFFSET) || !candidate.skipString())
+          return false;
+      }
+
+      return candidate.pos == candidate.end;
+    }
+
+    bool validatePlate(BinaryCursor& cursor)
+    {
+      BinaryCursor plate(NULL, NULL);
+      uint32_t bestIndex;
+      uint32_t candidateCount;
+      if (!cursor.enterRecord(plate) || !plate.skip(PLATE_REGION_OFFSET - 4) || !plate.skipString() ||
+          !plate.readUint32(bestIndex) || !plate.readUint32(candidateCount))
+        return false;
+
+      int32_t best = (int32_t) bestIndex;
+      if (best < -1 || (best >= 0 && (uint32_t) best >= candidateCount))
+        return false;
+
+      for (uint32_t i = 0; i < candidateCount; i++)
+      {
+        if (!validateCandidate(plate))
+          return false;
+      }
+
+      if (best < 0 && !validateCandidate(plate))
+        return false;
+
+      return plate.pos == plate.end;
+    }
+  }
+
+  void writeBinaryResults(const AlprResults& results, string& output)
+  {
+    output.reserve(output.size() + BINARY_BASE_SIZE_ESTIMATE + results.plates.size() * BINARY_PLATE_SIZE_ESTIMATE);
+
+    size_t start = output.size();
+    output.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    appendUint16(output, ALPR_BINARY_VERSION);
+    appendUint16(output, 0);
+    appendUint32(output, 0);
+
+    appendInt64(output, results.epoch_time);
+    appendInt32(output, results.img_width);
+    appendInt32(output, results.img_height);
+    appendFloat(output, results.total_processing_time_ms);
+
+    appendUint32(output, (uint32_t) results.regionsOfInterest.size());
+    for (unsigned int i = 0; i < results.regionsOfInterest.size(); i++)
+    {
+      appendInt32(output, results.regionsOfInterest[i].x);
+      appendInt32(output, results.regionsOfInterest[i].y);
+      appendInt32(output, results.regionsOfInterest[i].width);
+      appendInt32(output, results.regionsOfInterest[i].height);
+    }
+
+    appendUint32(output, (uint32_t) results.plates.size());
+    for (unsigned int i = 0; i < results.plates.size(); i++)
+      writePlate(output, results.plates[i]);
+
+    patchUint32(output, start + MESSAGE_LENGTH_OFFSET, (uint32_t) (output.size() - start));
+  }
+
+  bool readBinaryResults(const char* data, size_t length, AlprResults& results)
+  {
+    AlprResultsReader reader(data, length);
+    if (!reader.isValid())
+      return false;
+
+    reader.toResults(results);
+    return true;
+  }
+
+  AlprCharView::AlprCharView(const char* data)
+  {
+    this->data = data;
+  }
+
+  AlprCoordinate AlprCharView::getCorner(int index) const
+  {
+    return readCoordinate(data + index * 8);
+  }
+
+  float AlprCharView::getConfidence() const
+  {
+    return readFloat(data + CHARACTER_CONFIDENCE_OFFSET);
+  }
+
+  AlprStringView AlprCharView::getCharacter() const
+  {
+    return readString(data + CHARACTER_STRING_OFFSET);
+  }
+
+  void AlprCharView::toChar(AlprChar& character) const
+  {
+    for (int c = 0; c < 4; c++)
+      character.corners[c] = getCorner(c);
+    character.confidence = getConfidence();
+
+    AlprStringView text = getCharacter();
+    character.character.assign(text.data, text.length);
+  }
+
+  AlprPlateView::AlprPlateView(const char* data)
+  {
+    this->data = data;
+    this->fields = data + CANDIDATE_CHARACTERS_OFFSET + 4 + readUint32(data + CANDIDATE_CHARACTERS_OFFSET);
+  }
+
+  AlprStringView AlprPlateView::getCharacters() const
+  {
+    return readString(data + CANDIDATE_CHARACTERS_OFFSET);
+  }
+
+  float AlprPlateView::getOverallConfidence() const
+  {
+    return readFloat(fields + CANDIDATE_CONFIDENCE_OFFSET);
+  }
+
+  bool AlprPlateView::getMatchesTemplate() const
+  {
+    return fields[CANDIDATE_MATCHES_TEMPLATE_OFFSET] != 0;
+  }
+
+  unsigned int AlprPlateView::getCharacterCount() const
+  {
+    return readUint32(fields + CANDIDATE_CHARACTER_COUNT_OFFSET);
+  }
+
+  AlprCharView AlprPlateView::getCharacter(unsigned int index) const
+  {
+    const char* character = fields + CANDIDATE_CHARACTERS_LIST_OFFSET;
+    for (unsigned int i = 0; i < index; i++)
+      character += CHARACTER_STRING_OFFSET + 4 + readUint32(character + CHARACTER_STRING_OFFSET);
+
+    return AlprCharView(character);
+  }
+
+  void AlprPlateView::toPlate(AlprPlate& plate) const
+  {
+    AlprStringView characters = getCharacters();
+    plate.characters.assign(characters.data, characters.length);
+    plate.overall_confidence = getOverallConfidence();
+    plate.matches_template = getMatchesTemplate();
+
+    unsigned int characterCount = getCharacterCount();
+    plate.character_details.resize(characterCount);
+
+    const char* character = fields + CANDIDATE_CHARACTERS_LIST_OFFSET;
+    for (unsigned int i = 0; i < characterCount; i++)
+    {
+      AlprCharView view(character);
+      view.toChar(plate.character_details[i]);
+      character += CHARACTER_STRING_OFFSET + 4 + readUint32(character + CHARACTER_STRING_OFFSET);
+    }
+  }
+
+  AlprPlateResultView::AlprPlateResultView(const char* data)
+  {
+    this->data = data;
+    this->fields = data + PLATE_REGION_OFFSET + 4 + readUint32(data + PLATE_REGION_OFFSET);
+  }
+
+  int AlprPlateResultView::getRequestedTopN() const
+  {
+    return readInt32(data + PLATE_REQUESTED_TOPN_OFFSET);
+  }
+
+  int AlprPlateResultView::getPlateIndex() const
+  {
+    return readInt32(data + PLATE_INDEX_OFFSET);
+  }
+
+  int AlprPlateResultView::getRegionConfidence() const
+  {
+    return readInt32(data + PLATE_REGION_CONFIDENCE_OFFSET);
+  }
+
+  float AlprPlateResultView::getProcessingTimeMs() const
+  {
+    return readFloat(data + PLATE_PROCESSING_TIME_OFFSET);
+  }
+
+  AlprCoordinate AlprPlateResultView::getPlatePoint(int index) const
+  {
+    return readCoordinate(data + PLATE_POINTS_OFFSET + index * 8);
+  }
+
+  AlprStringView AlprPlateResultView::getRegion() const
+  {
+    return readString(data + PLATE_REGION_OFFSET);
+  }
+
+  AlprPlateView AlprPlateResultView::getBestPlate() const
+  {
+    int bestIndex = readInt32(fields + PLATE_BEST_INDEX_OFFSET);
+
+    // Stored right after the candidates when it isn't one of them
+    if (bestIndex < 0)
+      return getCandidate(getCandidateCount());
+
+    return getCandidate(bestIndex);
+  }
+
+  unsigned int AlprPlateResultView::getCandidateCount() const
+  {
+    return readUint32(fields + PLATE_CANDIDATE_COUNT_OFFSET);
+  }
+
+  AlprPlateView AlprPlateResultView::getCandidate(unsigned int index) const
+  {
+    const char* candidate = fields + PLATE_CANDIDATES_OFFSET;
+    for (unsigned int i = 0; i < index; i++)
+      candidate += 4 + readUint32(candidate);
+
+    return AlprPlateView(candidate);
+  }
+
+  void AlprPlateResultView::toPlateResult(AlprPlateResult& plateResult) const
+  {
+    plateResult.requested_topn = getRequestedTopN();
+    plateResult.plate_index = getPlateIndex();
+    plateResult.regionConfidence = getRegionConfidence();
+    plateResult.processing_time_ms = getProcessingTimeMs();
+    for (int i = 0; i < 4; i++)
+      plateResult.plate_points[i] = getPlatePoint(i);
+
+    AlprStringView region = getRegion();
+    plateResult.region.assign(region.data, region.length);
+
+    unsigned int candidateCount = getCandidateCount();
+    plateResult.topNPlates.resize(candidateCount);
+
+    const char* candidate = fields + PLATE_CANDIDATES_OFFSET;
+    for (unsigned int i = 0; i < candidateCount; i++)
+    {
+      AlprPlateView view(candidate);
+      view.toPlate(plateResult.topNPlates[i]);
+      candidate += 4 + readUint32(candidate);
+    }
+
+    int bestIndex = readInt32(fields + PLATE_BEST_INDEX_OFFSET);
+    if (bestIndex < 0)
+      AlprPlateView(candidate).toPlate(plateResult.bestPlate);
+    else
+      plateResult.bestPlate = plateResult.topNPlates[bestIndex];
+  }
+
+  AlprResultsReader::AlprResultsReader(const char* data, size_t length)
+  {
+    this->data = data;
+    this->plates = NULL;
+    this->valid = validate(length);
+  }
+
+  bool AlprResultsReader::validate(size_t length)
+  {
+    if (data == NULL || length < HEADER_SIZE || memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+      return false;
+
+    if (getVersion() != ALPR_BINARY_VERSION)
+      return false;
+
+    uint32_t messageLength = getMessageLength();
+    if (messageLength < HEADER_SIZE || messageLength > length)
+      return false;
+
+    BinaryCursor cursor(data + HEADER_SIZE, data + messageLength);
+
+    uint32_t roiCount;
+    if (!cursor.skip(ROI_COUNT_OFFSET - HEADER_SIZE) || !cursor.readUint32(roiCount))
+      return false;
+
+    if (roiCount > (size_t) (cursor.end - cursor.pos) / ROI_SIZE)
+      return false;
+    cursor.skip(roiCount * ROI_SIZE);
+
+    uint32_t plateCount;
+    if (!cursor.readUint32(plateCount))
+      return false;
+
+    plates = cursor.pos;
+    for (uint32_t i = 0; i < plateCount; i++)
+    {
+      if (!validatePlate(cursor))
+        return false;
+    }
+
+    return cursor.pos == cursor.end;
+  }
+
+  bool AlprResultsReader::isValid() const
+  {
+    return valid;
+  }
+
+  uint16_t AlprResultsReader::getVersion() const
+  {
+    return readUint16(data + VERSION_OFFSET);
+  }
+
+  uint32_t AlprResultsReader::getMessageLength() const
+  {
+    return readUint32(data + MESSAGE_LENGTH_OFFSET);
+  }
+
+  int64_t AlprResultsReader::getEpochTime() const
+  {
+    return readInt64(data + EPOCH_TIME_OFFSET);
+  }
+
+  int AlprResultsReader::getImgWidth() const
+  {
+    return readInt32(data + IMG_WIDTH_OFFSET);
+  }
+
+  int AlprResultsReader::getImgHeight() const
+  {
+    return readInt32(data + IMG_HEIGHT_OFFSET);
+  }
+
+  float AlprResultsReader::getTotalProcessingTimeMs() const
+  {
+    return readFloat(data + TOTAL_PROCESSING_TIME_OFFSET);
+  }
+
+  unsigned int AlprResultsReader::getRegionOfInterestCount() const
+  {
+    return readUint32(data + ROI_COUNT_OFFSET);
+  }
+
+  AlprRegionOfInterest AlprResultsReader::getRegionOfInterest(unsigned int index) const
+  {
+    const char* roi = data + ROI_COUNT_OFFSET + 4 + index * ROI_SIZE;
+    return AlprRegionOfInterest(readInt32(roi), readInt32(roi + 4), readInt32(roi + 8), readInt32(roi + 12));
+  }
+
+  unsigned int AlprResultsReader::getPlateCount() const
+  {
+    return readUint32(plates - 4);
+  }
+
+  AlprPlateResultView AlprResultsReader::getPlate(unsigned int index) const
+  {
+    const char* plate = plates;
+    for (unsigned int i = 0; i < index; i++)
+      plate += 4 + readUint32(plate);
+
+    return AlprPlateResultView(plate);
+  }
+
+  void AlprResultsReader::toResults(AlprResults& results) const
+  {
+    results.epoch_time = getEpochTime();
+    results.img_width = getImgWidth();
+    results.img_height = getImgHeight();
+    results.total_processing_time_ms = getTotalProcessingTimeMs();
+
+    unsigned int roiCount = getRegionOfInterestCount();
+    results.regionsOfInterest.clear();
+    results.regionsOfInterest.reserve(roiCount);
+    for (unsigned int i = 0; i < roiCount; i++)
+      results.regionsOfInterest.push_back(getRegionOfInterest(i));
+
+    unsigned int plateCount = getPlateCount();
+    results.plates.resize(plateCount);
+
+    const char* plate = plates;
+    for (unsigned int i = 0; i < plateCount; i++)
+    {
+      AlprPlateResultView view(plate);
+      view.toPlateResult(results.plates[i]);
+      plate += 4 + readUint32(plate);
+    }
+  }
+
+}
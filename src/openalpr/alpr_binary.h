@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_ALPR_BINARY_H
+#define OPENALPR_ALPR_BINARY_H
+
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "alpr.h"
+
+// Compact binary encoding of AlprResults, for queues and bindings that would otherwise parse JSON.
+// Every value is little endian.  Lengths let a reader skip a plate or candidate without decoding it.
+//
+//   header:     "ALPR", uint16 version, uint16 reserved (0), uint32 message length including the header
+//   results:    int64 epoch_time, int32 img_width, int32 img_height, float32 total_processing_time_ms,
+//               uint32 region of interest count, int32 x/y/width/height per region of interest,
+//               uint32 plate count, plates
+//   plate:      uint32 length of the rest of the plate, int32 requested_topn, int32 plate_index,
+//               int32 region_confidence, float32 processing_time_ms, int32 x/y for each of the 4 corners,
+//               string region, int32 index of the best plate among the candidates (-1 when the best plate
+//               is stored after them), uint32 candidate count, candidates
+//   candidate:  uint32 length of the rest of the candidate, string characters, float32 overall_confidence,
+//               uint8 matches_template, uint32 character count, characters
+//   character:  int32 x/y for each of the 4 corners, float32 confidence, string character
+//   string:     uint32 byte count, UTF-8 bytes without a terminating null
+
+namespace alpr
+{
+
+  const uint16_t ALPR_BINARY_VERSION = 1;
+
+  // Appends the encoded results to the output, so one buffer can hold several messages
+  void writeBinaryResults(const AlprResults& results, std::string& output);
+
+  // Decodes a message into results.  False if the data is not a valid message.
+  bool readBinaryResults(const char* data, size_t length, AlprResults& results);
+
+  // Bytes of a string inside the message buffer
+  struct AlprStringView
+  {
+    const char* data;
+    uint32_t length;
+
+    std::string str() const { return std::string(data, length); }
+  };
+
+  // The views below point into the message buffer, which has to outlive them.  They are only
+  // handed out by a valid AlprResultsReader, so they don't check bounds themselves.
+
+  class AlprCharView
+  {
+    public:
+      AlprCoordinate getCorner(int index) const;
+      float getConfidence() const;
+      AlprStringView getCharacter() const;
+
+      void toChar(AlprChar& character) const;
+
+    private:
+      friend class AlprPlateView;
+      AlprCharView(const char* data);
+
+      const char* data;
+  };
+
+  class AlprPlateView
+  {
+    public:
+      AlprStringView getCharacters() const;
+      float getOverallConfidence() const;
+      bool getMatchesTemplate() const;
+
+      unsigned int getCharacterCount() const;
+      // Walks the characters before the index
+      AlprCharView getCharacter(unsigned int index) const;
+
+      void toPlate(AlprPlate& plate) const;
+
+    private:
+      friend class AlprPlateResultView;
+      AlprPlateView(const char* data);
+
+      const char* data;
+      // The fields following the characters string
+      const char* fields;
+  };
+
+  class AlprPlateResultView
+  {
+    public:
+      int getRequestedTopN() const;
+      int getPlateIndex() const;
+      int getRegionConfidence() const;
+      float getProcessingTimeMs() const;
+      AlprCoordinate getPlatePoint(int index) const;
+      AlprStringView getRegion() const;
+
+      AlprPlateView getBestPlate() const;
+
+      unsigned int getCandidateCount() const;
+      // Skips over the candidates before the index
+      AlprPlateView getCandidate(unsigned int index) const;
+
+      void toPlateResult(AlprPlateResult& plateResult) const;
+
+    private:
+      friend class AlprResultsReader;
+      AlprPlateResultView(const char* data);
+
+      const char* data;
+      // The fields following the region string
+      const char* fields;
+  };
+
+  // Reads a message in place.  The whole message is validated once when the reader is created.
+  class AlprResultsReader
+  {
+    public:
+      // The buffer may continue past the message, getMessageLength tells where the next one starts
+      AlprResultsReader(const char* data, size_t length);
+
+      // False when the data is not a complete message of a known version.  Nothing else may be called then.
+      bool isValid() const;
+
+      uint16_t getVersion() const;
+      uint32_t getMessageLength() const;
+
+      int64_t getEpochTime() const;
+      int getImgWidth() const;
+      int getImgHeight() const;
+      float getTotalProcessingTimeMs() const;
+
+      unsigned int getRegionOfInterestCount() const;
+      AlprRegionOfInterest getRegionOfInterest(unsigned int index) const;
+
+      unsigned int getPlateCount() const;
+      // Skips over the plates before the index
+      AlprPlateResultView getPlate(unsigned int index) const;
+
+      void toResults(AlprResults& results) const;
+
+    private:
+      const char* data;
+      bool valid;
+
+      const char* plates;
+
+      bool validate(size_t length);
+  };
+
+}
+
+#endif // OPENALPR_ALPR_BINARY_H
@@ -18,6 +18,7 @@
 */
 
 #include "alpr_impl.h"
+#include <limits.h>
 
 
 void plateAnalysisThread(void* arg);
@@ -43,11 +44,12 @@ namespace alpr
     }
 
     plateDetector = createDetector(config);
-    ocr = new OCR(config);
+    ocr = createOcr(config);
     setNumThreads(0);
 
     setDetectRegion(DEFAULT_DETECT_REGION);
     this->topN = DEFAULT_TOPN;
+    this->includeCharacterDetails = DEFAULT_INCLUDE_CHARACTER_DETAILS;
     setDefaultRegion("");
     
     prewarp = new PreWarp(config);
@@ -75,6 +77,21 @@ namespace alpr
     return config->loaded;
   }
 
+  FrameContext* AlprImpl::getFrameContext()
+  {
+    return &frameContext;
+  }
+
+
+  // The regions and all of their children
+  static int countPlateRegions(const vector<PlateRegion>& regions)
+  {
+    int count = regions.size();
+    for (unsigned int i = 0; i < regions.size(); i++)
+      count += countPlateRegions(regions[i].children);
+
+    return count;
+  }
 
   AlprFullDetails AlprImpl::recognizeFullDetails(cv::Mat img, std::vector<cv::Rect> regionsOfInterest)
   {
@@ -104,15 +121,16 @@ namespace alpr
     }
 
     // Convert image to grayscale if required
-    Mat grayImg = img;
-    if (img.channels() > 2)
-      cvtColor( img, grayImg, CV_BGR2GRAY );
+    Mat grayImg = frameContext.convertToGray(img);
+
+    // Nothing after this point reads the colour image, so grayscale mode doesn't keep it
+    Mat colorImg;
+    if (!config->grayscaleOnly)
+      colorImg = img;
     
-    // Prewarp the image and ROIs if configured]
-    std::vector<cv::Rect> warpedRegionsOfInterest = regionsOfInterest;
-    // Warp the image if prewarp is provided
-    grayImg = prewarp->warpImage(grayImg);
-    warpedRegionsOfInterest = prewarp->projectRects(regionsOfInterest, grayImg.cols, grayImg.rows, false);
+    // Prewarp the image and ROIs if configured.  Only the ROIs are warped when they are a small part of the image
+    std::vector<cv::Rect> warpedRegionsOfInterest;
+    grayImg = prewarp->warpRegionsOfInterest(grayImg, regionsOfInterest, warpedRegionsOfInterest);
     
     vector<PlateRegion> warpedPlateRegions;
     // Find all the candidate regions
@@ -132,17 +150,21 @@ namespace alpr
       }
     }
 
-    queue<PlateRegion> plateQueue;
+    vector<const PlateRegion*>& plateQueue = frameContext.plateQueue;
+    plateQueue.clear();
     for (unsigned int i = 0; i < warpedPlateRegions.size(); i++)
-      plateQueue.push(warpedPlateRegions[i]);
+      plateQueue.push_back(&warpedPlateRegions[i]);
+
+    // Growing the plates would copy every plate result found so far.  Any region or child region can be a plate.
+    response.results.plates.reserve(countPlateRegions(warpedPlateRegions));
 
     int platecount = 0;
-    while(!plateQueue.empty())
+    // The queue grows as rejected regions add their children
+    for (unsigned int queueIndex = 0; queueIndex < plateQueue.size(); queueIndex++)
     {
-      PlateRegion plateRegion = plateQueue.front();
-      plateQueue.pop();
+      const PlateRegion& plateRegion = *plateQueue[queueIndex];
 
-      PipelineData pipeline_data(img, grayImg, plateRegion.rect, config);
+      PipelineData& pipeline_data = *frameContext.beginPlate(colorImg, grayImg, plateRegion.rect, config);
 
       timespec platestarttime;
       getTimeMonotonic(&platestarttime);
@@ -185,54 +207,20 @@ namespace alpr
           std::cerr << "Valid patterns are located in the " << config->country << ".patterns file" << std::endl;
         }
 
+        // A default region narrows the OCR to the letters its patterns allow.  A region that was
+        // identified from the plate may be wrong, so it doesn't restrict the letters.
+        if (defaultRegion.size() > 0 && plateResult.region == defaultRegion)
+          ocr->setWhitelistRegion(defaultRegion);
+        else
+          ocr->setWhitelistRegion("");
+
         ocr->performOCR(&pipeline_data);
         ocr->postProcessor.analyze(plateResult.region, topN);
 
         timespec resultsStartTime;
         getTimeMonotonic(&resultsStartTime);
 
-        const vector<PPResult> ppResults = ocr->postProcessor.getResults();
-
-        int bestPlateIndex = 0;
-
-        cv::Mat charTransformMatrix = getCharacterTransformMatrix(&pipeline_data);
-        for (unsigned int pp = 0; pp < ppResults.size(); pp++)
-        {
-
-          // Set our "best plate" match to either the first entry, or the first entry with a postprocessor template match
-          if (bestPlateIndex == 0 && ppResults[pp].matchesTemplate)
-            bestPlateIndex = plateResult.topNPlates.size();
-            
-          AlprPlate aplate;
-          aplate.characters = ppResults[pp].letters;
-          aplate.overall_confidence = ppResults[pp].totalscore;
-          aplate.matches_template = ppResults[pp].matchesTemplate;
-            
-          // Grab detailed results for each character
-          for (unsigned int c_idx = 0; c_idx < ppResults[pp].letter_details.size(); c_idx++)
-          {
-            AlprChar character_details;
-            character_details.character = ppResults[pp].letter_details[c_idx].letter;
-            character_details.confidence = ppResults[pp].letter_details[c_idx].totalscore;
-            cv::Rect char_rect = pipeline_data.charRegions[ppResults[pp].letter_details[c_idx].charposition];
-            std::vector<AlprCoordinate> charpoints = getCharacterPoints(char_rect, charTransformMatrix );
-            for (int cpt = 0; cpt < 4; cpt++)
-              character_details.corners[cpt] = charpoints[cpt];
-            aplate.character_details.push_back(character_details);
-          }
-          plateResult.topNPlates.push_back(aplate);
-        }
-
-        if (plateResult.topNPlates.size() > bestPlateIndex)
-        {
-          AlprPlate bestPlate;
-          bestPlate.characters = plateResult.topNPlates[bestPlateIndex].characters;
-          bestPlate.matches_template = plateResult.topNPlates[bestPlateIndex].matches_template;
-          bestPlate.overall_confidence = plateResult.topNPlates[bestPlateIndex].overall_confidence;
-          bestPlate.character_details = plateResult.topNPlates[bestPlateIndex].character_details;
-          
-          plateResult.bestPlate = bestPlate;
-        }
+        addPlateCandidates(ocr->postProcessor.getResults(), &pipeline_data, plateResult);
 
         timespec plateEndTime;
         getTimeMonotonic(&plateEndTime);
@@ -245,7 +233,10 @@ namespace alpr
         if (plateResult.topNPlates.size() > 0)
         {
           plateDetected = true;
-          response.results.plates.push_back(plateResult);
+
+          // Swapped in rather than copied, along with all of its candidates
+          response.results.plates.resize(response.results.plates.size() + 1);
+          response.results.plates.back().swap(plateResult);
         }
       }
 
@@ -255,15 +246,17 @@ namespace alpr
         // Check if this plate has any children, if so, send them back up for processing
         for (unsigned int childidx = 0; childidx < plateRegion.children.size(); childidx++)
         {
-          plateQueue.push(plateRegion.children[childidx]);
+          plateQueue.push_back(&plateRegion.children[childidx]);
         }
       }
 
     }
 
+    frameContext.endFrame();
+
     // Unwarp plate regions if necessary
     prewarp->projectPlateRegions(warpedPlateRegions, grayImg.cols, grayImg.rows, true);
-    response.plateRegions = warpedPlateRegions;
+    response.plateRegions.swap(warpedPlateRegions);
     
     timespec endTime;
     getTimeMonotonic(&endTime);
@@ -329,9 +322,11 @@ namespace alpr
 
 
 
-  AlprResults AlprImpl::recognize( std::vector<char> imageBytes)
+  AlprResults AlprImpl::recognize( const std::vector<char>& imageBytes)
   {
-    cv::Mat img = cv::imdecode(cv::Mat(imageBytes), 1);
+    // Decoding straight to gray skips the colour conversion and a 3 channel copy of the image
+    int decodeFlags = config->grayscaleOnly ? CV_LOAD_IMAGE_GRAYSCALE : CV_LOAD_IMAGE_COLOR;
+    cv::Mat img = cv::imdecode(cv::Mat(imageBytes), decodeFlags);
 
     return this->recognize(img);
   }
@@ -370,7 +365,10 @@ namespace alpr
   AlprResults AlprImpl::recognize(cv::Mat img, std::vector<cv::Rect> regionsOfInterest)
   {
     AlprFullDetails fullDetails = recognizeFullDetails(img, regionsOfInterest);
-    return fullDetails.results;
+
+    AlprResults results;
+    results.swap(fullDetails.results);
+    return results;
   }
 
 
@@ -398,183 +396,428 @@ namespace alpr
      return intersectedRects;
    }
 
-  string AlprImpl::toJson( const AlprResults results )
+  string AlprImpl::toJson( const AlprResults& results )
+  {
+    string json;
+    json.reserve(JSON_BASE_SIZE_ESTIMATE + results.plates.size() * JSON_PLATE_SIZE_ESTIMATE);
+
+    toJson(results, json);
+    return json;
+  }
+
+  string AlprImpl::toJson( const AlprResults& results, const vector<AlprJsonField>& extraFields )
   {
-    cJSON *root, *jsonResults;
-    root = cJSON_CreateObject();
+    string json;
+    json.reserve(JSON_BASE_SIZE_ESTIMATE + results.plates.size() * JSON_PLATE_SIZE_ESTIMATE);
 
+    toJson(results, json, extraFields);
+    return json;
+  }
+
+  void AlprImpl::toJson( const AlprResults& results, std::string& json, const vector<AlprJsonField>& extraFields )
+  {
+    json.clear();
+    JsonWriter writer(json);
 
-    cJSON_AddNumberToObject(root,"version",	2	  );
-    cJSON_AddStringToObject(root,"data_type",	"alpr_results"	  );
+    writer.beginObject();
 
-    cJSON_AddNumberToObject(root,"epoch_time",	results.epoch_time	  );
-    cJSON_AddNumberToObject(root,"img_width",	results.img_width	  );
-    cJSON_AddNumberToObject(root,"img_height",	results.img_height	  );
-    cJSON_AddNumberToObject(root,"processing_time_ms", results.total_processing_time_ms );
+    writer.addNumber("version",	2	  );
+    writer.addString("data_type",	"alpr_results"	  );
+
+    writer.addNumber("epoch_time",	results.epoch_time	  );
+    writer.addNumber("img_width",	results.img_width	  );
+    writer.addNumber("img_height",	results.img_height	  );
+    writer.addNumber("processing_time_ms", results.total_processing_time_ms );
 
     // Add the regions of interest to the JSON
-    cJSON *rois;
-    cJSON_AddItemToObject(root, "regions_of_interest", 		rois=cJSON_CreateArray());
+    writer.beginArray("regions_of_interest");
     for (unsigned int i=0;i<results.regionsOfInterest.size();i++)
     {
-      cJSON *roi_object;
-      roi_object = cJSON_CreateObject();
-      cJSON_AddNumberToObject(roi_object, "x",  results.regionsOfInterest[i].x);
-      cJSON_AddNumberToObject(roi_object, "y",  results.regionsOfInterest[i].y);
-      cJSON_AddNumberToObject(roi_object, "width",  results.regionsOfInterest[i].width);
-      cJSON_AddNumberToObject(roi_object, "height",  results.regionsOfInterest[i].height);
-
-      cJSON_AddItemToArray(rois, roi_object);
+      writer.beginObject();
+      writer.addNumber("x",  results.regionsOfInterest[i].x);
+      writer.addNumber("y",  results.regionsOfInterest[i].y);
+      writer.addNumber("width",  results.regionsOfInterest[i].width);
+      writer.addNumber("height",  results.regionsOfInterest[i].height);
+      writer.endObject();
     }
+    writer.endArray();
 
-
-    cJSON_AddItemToObject(root, "results", 		jsonResults=cJSON_CreateArray());
+    writer.beginArray("results");
     for (unsigned int i = 0; i < results.plates.size(); i++)
+      writePlateJson(writer, results.plates[i]);
+    writer.endArray();
+
+    for (unsigned int i = 0; i < extraFields.size(); i++)
     {
-      cJSON *resultObj = createJsonObj( &results.plates[i] );
-      cJSON_AddItemToArray(jsonResults, resultObj);
+      if (extraFields[i].is_number)
+        writer.addNumber(extraFields[i].name.c_str(), extraFields[i].number_value);
+      else
+        writer.addString(extraFields[i].name.c_str(), extraFields[i].string_value);
     }
 
-    // Print the JSON object to a string and return
-    char *out;
-    out=cJSON_PrintUnformatted(root);
+    writer.endObject();
+  }
 
-    cJSON_Delete(root);
+  void AlprImpl::writePlateJson(JsonWriter& writer, const AlprPlateResult& result)
+  {
+    writer.beginObject();
 
-    string response(out);
+    writer.addString("plate",		result.bestPlate.characters);
+    writer.addNumber("confidence",		result.bestPlate.overall_confidence);
+    writer.addNumber("matches_template",	result.bestPlate.matches_template);
 
-    free(out);
-    return response;
-  }
+    writer.addNumber("plate_index",               result.plate_index);
 
+    writer.addString("region",		result.region);
+    writer.addNumber("region_confidence",	result.regionConfidence);
 
+    writer.addNumber("processing_time_ms",	result.processing_time_ms);
+    writer.addNumber("requested_topn",	result.requested_topn);
 
-  cJSON* AlprImpl::createJsonObj(const AlprPlateResult* result)
-  {
-    cJSON *root, *coords, *candidates;
+    writer.beginArray("coordinates");
+    for (int i=0;i<4;i++)
+    {
+      writer.beginObject();
+      writer.addNumber("x",  result.plate_points[i].x);
+      writer.addNumber("y",  result.plate_points[i].y);
+      writer.endObject();
+    }
+    writer.endArray();
 
-    root=cJSON_CreateObject();
+    writer.beginArray("candidates");
+    for (unsigned int i = 0; i < result.topNPlates.size(); i++)
+    {
+      writer.beginObject();
+      writer.addString("plate",  result.topNPlates[i].characters);
+      writer.addNumber("confidence",  result.topNPlates[i].overall_confidence);
+      writer.addNumber("matches_template",  result.topNPlates[i].matches_template);
+      writer.endObject();
+    }
+    writer.endArray();
 
-    cJSON_AddStringToObject(root,"plate",		result->bestPlate.characters.c_str());
-    cJSON_AddNumberToObject(root,"confidence",		result->bestPlate.overall_confidence);
-    cJSON_AddNumberToObject(root,"matches_template",	result->bestPlate.matches_template);
+    writer.endObject();
+  }
 
-    cJSON_AddNumberToObject(root,"plate_index",               result->plate_index);
+  namespace
+  {
+    bool readJsonInt(JsonReader& reader, int& value)
+    {
+      double number;
+      if (!reader.readNumber(number))
+        return false;
 
-    cJSON_AddStringToObject(root,"region",		result->region.c_str());
-    cJSON_AddNumberToObject(root,"region_confidence",	result->regionConfidence);
+      if (number < INT_MIN || number > INT_MAX)
+        return reader.fail("Number out of range");
 
-    cJSON_AddNumberToObject(root,"processing_time_ms",	result->processing_time_ms);
-    cJSON_AddNumberToObject(root,"requested_topn",	result->requested_topn);
+      value = (int) number;
+      return true;
+    }
 
-    cJSON_AddItemToObject(root, "coordinates", 		coords=cJSON_CreateArray());
-    for (int i=0;i<4;i++)
+    bool readJsonFloat(JsonReader& reader, float& value)
     {
-      cJSON *coords_object;
-      coords_object = cJSON_CreateObject();
-      cJSON_AddNumberToObject(coords_object, "x",  result->plate_points[i].x);
-      cJSON_AddNumberToObject(coords_object, "y",  result->plate_points[i].y);
+      double number;
+      if (!reader.readNumber(number))
+        return false;
 
-      cJSON_AddItemToArray(coords, coords_object);
+      value = (float) number;
+      return true;
     }
 
-
-    cJSON_AddItemToObject(root, "candidates", 		candidates=cJSON_CreateArray());
-    for (unsigned int i = 0; i < result->topNPlates.size(); i++)
+    // An array of 4 {"x", "y"} objects
+    bool readJsonCorners(JsonReader& reader, AlprCoordinate* corners)
     {
-      cJSON *candidate_object;
-      candidate_object = cJSON_CreateObject();
-      cJSON_AddStringToObject(candidate_object, "plate",  result->topNPlates[i].characters.c_str());
-      cJSON_AddNumberToObject(candidate_object, "confidence",  result->topNPlates[i].overall_confidence);
-      cJSON_AddNumberToObject(candidate_object, "matches_template",  result->topNPlates[i].matches_template);
+      int count = 0;
+      string key;
 
-      cJSON_AddItemToArray(candidates, candidate_object);
-    }
+      if (!reader.beginArray())
+        return false;
+
+      while (reader.nextElement())
+      {
+        if (count == 4)
+          return reader.fail("Expected 4 coordinates");
+
+        corners[count].x = 0;
+        corners[count].y = 0;
+
+        if (!reader.beginObject())
+          return false;
+        while (reader.nextKey(key))
+        {
+          if (key == "x")
+            readJsonInt(reader, corners[count].x);
+          else if (key == "y")
+            readJsonInt(reader, corners[count].y);
+          else
+            reader.skipValue();
+        }
+
+        count++;
+      }
+
+      if (reader.hasError())
+        return false;
+      if (count != 4)
+        return reader.fail("Expected 4 coordinates");
 
-    return root;
+      return true;
+    }
   }
 
   AlprResults AlprImpl::fromJson(std::string json) {
     AlprResults allResults;
+    string error;
 
-    cJSON* root = cJSON_Parse(json.c_str());
+    if (!fromJson(json, allResults, error))
+      std::cerr << "Invalid results JSON: " << error << std::endl;
 
-    int version = cJSON_GetObjectItem(root, "version")->valueint;
-    allResults.epoch_time = (int64_t) cJSON_GetObjectItem(root, "epoch_time")->valuedouble;
-    allResults.img_width = cJSON_GetObjectItem(root, "img_width")->valueint;
-    allResults.img_height = cJSON_GetObjectItem(root, "img_height")->valueint;
-    allResults.total_processing_time_ms = cJSON_GetObjectItem(root, "processing_time_ms")->valueint;
+    return allResults;
+  }
+
+  bool AlprImpl::fromJson(const std::string& json, AlprResults& results, std::string& error)
+  {
+    results.epoch_time = 0;
+    results.img_width = 0;
+    results.img_height = 0;
+    results.total_processing_time_ms = 0;
+    results.plates.clear();
+    results.regionsOfInterest.clear();
+
+    JsonReader reader(json.data(), json.size());
+    string key;
+    string text;
+    bool hasResults = false;
+
+    if (reader.beginObject())
+    {
+      while (reader.nextKey(key))
+      {
+        if (key == "epoch_time")
+        {
+          double epochTime;
+          if (reader.readNumber(epochTime))
+            results.epoch_time = (int64_t) epochTime;
+        }
+        else if (key == "img_width")
+          readJsonInt(reader, results.img_width);
+        else if (key == "img_height")
+          readJsonInt(reader, results.img_height);
+        else if (key == "processing_time_ms")
+          readJsonFloat(reader, results.total_processing_time_ms);
+        else if (key == "data_type")
+        {
+          if (reader.readString(text) && text != "alpr_results")
+            reader.fail("Unexpected data_type " + text);
+        }
+        else if (key == "regions_of_interest")
+        {
+          if (reader.beginArray())
+          {
+            while (reader.nextElement())
+            {
+              AlprRegionOfInterest roi(0, 0, 0, 0);
+              if (!reader.beginObject())
+                break;
+              while (reader.nextKey(key))
+              {
+                if (key == "x")
+                  readJsonInt(reader, roi.x);
+                else if (key == "y")
+                  readJsonInt(reader, roi.y);
+                else if (key == "width")
+                  readJsonInt(reader, roi.width);
+                else if (key == "height")
+                  readJsonInt(reader, roi.height);
+                else
+                  reader.skipValue();
+              }
+              results.regionsOfInterest.push_back(roi);
+            }
+          }
+        }
+        else if (key == "results")
+        {
+          hasResults = true;
+          if (reader.beginArray())
+          {
+            while (reader.nextElement())
+            {
+              AlprPlateResult plate;
+              if (!readPlateJson(reader, plate))
+                break;
+              results.plates.push_back(plate);
+            }
+          }
+        }
+        else
+        {
+          // e.g., the uuid and camera_id alprd adds
+          reader.skipValue();
+        }
+      }
 
+      if (!reader.hasError() && !hasResults)
+        reader.fail("Missing results");
+    }
 
-    cJSON* rois = cJSON_GetObjectItem(root,"regions_of_interest");
-    int numRois = cJSON_GetArraySize(rois);
-    for (int c = 0; c < numRois; c++)
+    if (!reader.finish())
     {
-      cJSON* roi = cJSON_GetArrayItem(rois, c);
-      int x = cJSON_GetObjectItem(roi, "x")->valueint;
-      int y = cJSON_GetObjectItem(roi, "y")->valueint;
-      int width = cJSON_GetObjectItem(roi, "width")->valueint;
-      int height = cJSON_GetObjectItem(roi, "height")->valueint;
-
-      AlprRegionOfInterest alprRegion(x,y,width,height);
-      allResults.regionsOfInterest.push_back(alprRegion);
+      error = reader.getError();
+      return false;
     }
 
-    cJSON* resultsArray = cJSON_GetObjectItem(root,"results");
-    int resultsSize = cJSON_GetArraySize(resultsArray);
+    return true;
+  }
 
-    for (int i = 0; i < resultsSize; i++)
+  bool AlprImpl::readPlateJson(JsonReader& reader, AlprPlateResult& result)
+  {
+    result.requested_topn = 0;
+    result.plate_index = 0;
+    result.regionConfidence = 0;
+    result.processing_time_ms = 0;
+    result.bestPlate.overall_confidence = 0;
+    result.bestPlate.matches_template = false;
+    for (int i = 0; i < 4; i++)
     {
-      cJSON* item = cJSON_GetArrayItem(resultsArray, i);
-      AlprPlateResult plate;
+      result.plate_points[i].x = 0;
+      result.plate_points[i].y = 0;
+    }
 
-      //plate.bestPlate = cJSON_GetObjectItem(item, "plate")->valuestring;
-      plate.processing_time_ms = cJSON_GetObjectItem(item, "processing_time_ms")->valuedouble;
-      plate.plate_index = cJSON_GetObjectItem(item, "plate_index")->valueint;
-      plate.region = std::string(cJSON_GetObjectItem(item, "region")->valuestring);
-      plate.regionConfidence = cJSON_GetObjectItem(item, "region_confidence")->valueint;
-      plate.requested_topn = cJSON_GetObjectItem(item, "requested_topn")->valueint;
+    string key;
+    bool hasPlate = false;
 
+    if (!reader.beginObject())
+      return false;
 
-      cJSON* coordinates = cJSON_GetObjectItem(item,"coordinates");
-      for (int c = 0; c < 4; c++)
+    while (reader.nextKey(key))
+    {
+      if (key == "plate")
+        hasPlate = reader.readString(result.bestPlate.characters);
+      else if (key == "confidence")
+        readJsonFloat(reader, result.bestPlate.overall_confidence);
+      else if (key == "matches_template")
+        reader.readBoolean(result.bestPlate.matches_template);
+      else if (key == "character_details")
+        readCharacterDetailsJson(reader, result.bestPlate.character_details);
+      else if (key == "plate_index")
+        readJsonInt(reader, result.plate_index);
+      else if (key == "region")
+        reader.readString(result.region);
+      else if (key == "region_confidence")
+        readJsonInt(reader, result.regionConfidence);
+      else if (key == "processing_time_ms")
+        readJsonFloat(reader, result.processing_time_ms);
+      else if (key == "requested_topn")
+        readJsonInt(reader, result.requested_topn);
+      else if (key == "coordinates")
+        readJsonCorners(reader, result.plate_points);
+      else if (key == "candidates")
       {
-        cJSON* coordinate = cJSON_GetArrayItem(coordinates, c);
-        AlprCoordinate alprcoord;
-        alprcoord.x = cJSON_GetObjectItem(coordinate, "x")->valueint;
-        alprcoord.y = cJSON_GetObjectItem(coordinate, "y")->valueint;
-
-        plate.plate_points[c] = alprcoord;
+        if (reader.beginArray())
+        {
+          while (reader.nextElement())
+          {
+            result.topNPlates.push_back(AlprPlate());
+            if (!readCandidateJson(reader, result.topNPlates.back()))
+              break;
+          }
+        }
       }
+      else
+        reader.skipValue();
+    }
 
-      cJSON* candidates = cJSON_GetObjectItem(item,"candidates");
-      int numCandidates = cJSON_GetArraySize(candidates);
-      for (int c = 0; c < numCandidates; c++)
-      {
-        cJSON* candidate = cJSON_GetArrayItem(candidates, c);
-        AlprPlate plateCandidate;
-        plateCandidate.characters = std::string(cJSON_GetObjectItem(candidate, "plate")->valuestring);
-        plateCandidate.overall_confidence = cJSON_GetObjectItem(candidate, "confidence")->valuedouble;
-        plateCandidate.matches_template = (cJSON_GetObjectItem(candidate, "matches_template")->valueint) != 0;
-
-        plate.topNPlates.push_back(plateCandidate);
+    if (reader.hasError())
+      return false;
+    if (!hasPlate)
+      return reader.fail("Missing plate");
 
-        if (c == 0)
+    // The best plate is one of the candidates, which may carry its character details
+    if (result.bestPlate.character_details.size() == 0)
+    {
+      for (unsigned int i = 0; i < result.topNPlates.size(); i++)
+      {
+        if (result.topNPlates[i].characters == result.bestPlate.characters)
         {
-          plate.bestPlate = plateCandidate;
+          result.bestPlate.character_details = result.topNPlates[i].character_details;
+          break;
         }
       }
-
-      allResults.plates.push_back(plate);
     }
 
+    return true;
+  }
 
-    cJSON_Delete(root);
+  bool AlprImpl::readCandidateJson(JsonReader& reader, AlprPlate& candidate)
+  {
+    candidate.overall_confidence = 0;
+    candidate.matches_template = false;
 
+    string key;
+    bool hasPlate = false;
 
-    return allResults;
+    if (!reader.beginObject())
+      return false;
+
+    while (reader.nextKey(key))
+    {
+      if (key == "plate")
+        hasPlate = reader.readString(candidate.characters);
+      else if (key == "confidence")
+        readJsonFloat(reader, candidate.overall_confidence);
+      else if (key == "matches_template")
+        reader.readBoolean(candidate.matches_template);
+      else if (key == "character_details")
+        readCharacterDetailsJson(reader, candidate.character_details);
+      else
+        reader.skipValue();
+    }
+
+    if (reader.hasError())
+      return false;
+    if (!hasPlate)
+      return reader.fail("Missing candidate plate");
+
+    return true;
   }
 
+  // An array of {"character", "confidence", "coordinates"} objects, one per character of the plate
+  bool AlprImpl::readCharacterDetailsJson(JsonReader& reader, vector<AlprChar>& characterDetails)
+  {
+    string key;
+
+    if (!reader.beginArray())
+      return false;
+
+    while (reader.nextElement())
+    {
+      characterDetails.push_back(AlprChar());
+      AlprChar& character = characterDetails.back();
+      character.confidence = 0;
+      for (int i = 0; i < 4; i++)
+      {
+        character.corners[i].x = 0;
+        character.corners[i].y = 0;
+      }
+
+      if (!reader.beginObject())
+        return false;
+
+      while (reader.nextKey(key))
+      {
+        if (key == "character")
+          reader.readString(character.character);
+        else if (key == "confidence")
+          readJsonFloat(reader, character.confidence);
+        else if (key == "coordinates")
+          readJsonCorners(reader, character.corners);
+        else
+          reader.skipValue();
+      }
+    }
+
+    return !reader.hasError();
+  }
 
   void AlprImpl::setDetectRegion(bool detectRegion)
   {
@@ -593,6 +836,18 @@ namespace alpr
   {
     this->defaultRegion = region;
   }
+  void AlprImpl::setIncludeCharacterDetails(bool includeCharacterDetails)
+  {
+    this->includeCharacterDetails = includeCharacterDetails;
+  }
+  void AlprImpl::setGrayscaleOnly(bool grayscaleOnly)
+  {
+    config->grayscaleOnly = grayscaleOnly;
+  }
+  bool AlprImpl::isGrayscaleOnly()
+  {
+    return config->grayscaleOnly;
+  }
 
   std::string AlprImpl::getVersion()
   {
@@ -602,6 +857,86 @@ namespace alpr
     return ss.str();
   }
   
+  void AlprImpl::addPlateCandidates(const vector<PPResult>& ppResults, PipelineData* pipeline_data, AlprPlateResult& plateResult)
+  {
+    unsigned int bestPlateIndex = 0;
+
+    // Filled in place, so no candidate or character is copied on its way into the result
+    plateResult.topNPlates.resize(ppResults.size());
+
+    // The candidates all read the same character regions, so their corners are only projected once
+    vector<AlprCoordinate> charCorners;
+    if (includeCharacterDetails && ppResults.size() > 0)
+      getCharacterCorners(pipeline_data, charCorners);
+
+    for (unsigned int pp = 0; pp < ppResults.size(); pp++)
+    {
+      const PPResult& ppResult = ppResults[pp];
+
+      // Set our "best plate" match to either the first entry, or the first entry with a postprocessor template match
+      if (bestPlateIndex == 0 && ppResult.matchesTemplate)
+        bestPlateIndex = pp;
+
+      AlprPlate& aplate = plateResult.topNPlates[pp];
+      aplate.characters = ppResult.letters;
+      aplate.overall_confidence = ppResult.totalscore;
+      aplate.matches_template = ppResult.matchesTemplate;
+
+      if (!includeCharacterDetails)
+      {
+        aplate.character_details.clear();
+        continue;
+      }
+
+      // Grab detailed results for each character
+      aplate.character_details.resize(ppResult.letter_details.size());
+      for (unsigned int c_idx = 0; c_idx < ppResult.letter_details.size(); c_idx++)
+      {
+        AlprChar& character_details = aplate.character_details[c_idx];
+        character_details.character = ppResult.letter_details[c_idx].letter;
+        character_details.confidence = ppResult.letter_details[c_idx].totalscore;
+
+        const AlprCoordinate* corners = &charCorners[ppResult.letter_details[c_idx].charposition * 4];
+        for (int cpt = 0; cpt < 4; cpt++)
+          character_details.corners[cpt] = corners[cpt];
+      }
+    }
+
+    // bestPlate is part of the public AlprPlateResult layout, so it stays a copy of the chosen candidate
+    if (plateResult.topNPlates.size() > bestPlateIndex)
+      plateResult.bestPlate = plateResult.topNPlates[bestPlateIndex];
+  }
+
+  void AlprImpl::getCharacterCorners(PipelineData* pipeline_data, vector<AlprCoordinate>& corners)
+  {
+    const vector<Rect>& charRegions = pipeline_data->charRegions;
+
+    corners.resize(charRegions.size() * 4);
+    if (charRegions.size() == 0)
+      return;
+
+    vector<Point2f> points;
+    points.reserve(charRegions.size() * 4);
+    for (unsigned int i = 0; i < charRegions.size(); i++)
+    {
+      const Rect& char_rect = charRegions[i];
+      points.push_back(Point2f(char_rect.x, char_rect.y));
+      points.push_back(Point2f(char_rect.x + char_rect.width, char_rect.y));
+      points.push_back(Point2f(char_rect.x + char_rect.width, char_rect.y + char_rect.height));
+      points.push_back(Point2f(char_rect.x, char_rect.y + char_rect.height));
+    }
+
+    // Every region in one call, rather than one transform and prewarp projection per character
+    cv::perspectiveTransform(points, points, getCharacterTransformMatrix(pipeline_data));
+    points = prewarp->projectPoints(points, true);
+
+    for (unsigned int i = 0; i < points.size(); i++)
+    {
+      corners[i].x = round(points[i].x);
+      corners[i].y = round(points[i].y);
+    }
+  }
+
   cv::Mat AlprImpl::getCharacterTransformMatrix(PipelineData* pipeline_data ) {
     std::vector<Point2f> crop_corners;
     crop_corners.push_back(Point2f(0,0));
@@ -38,12 +38,15 @@
 #include "stateidentifier.h"
 #include "segmentation/charactersegmenter.h"
 #include "ocr.h"
+#include "ocr/ocrfactory.h"
 
 #include "constants.h"
 
-#include "cjson.h"
+#include "jsonwriter.h"
+#include "jsonreader.h"
 
 #include "pipeline_data.h"
+#include "framecontext.h"
 
 #include "prewarp.h"
 
@@ -54,9 +57,14 @@
 
 #define DEFAULT_TOPN 25
 #define DEFAULT_DETECT_REGION false
+#define DEFAULT_INCLUDE_CHARACTER_DETAILS true
 
 #define ALPR_NULL_PTR 0
 
+// Starting buffer sizes for toJson, so it rarely has to grow
+#define JSON_BASE_SIZE_ESTIMATE 512
+#define JSON_PLATE_SIZE_ESTIMATE 2048
+
 namespace alpr
 {
 
@@ -75,27 +83,50 @@ namespace alpr
 
       AlprFullDetails recognizeFullDetails(cv::Mat img, std::vector<cv::Rect> regionsOfInterest);
 
-      AlprResults recognize( std::vector<char> imageBytes );
+      AlprResults recognize( const std::vector<char>& imageBytes );
       AlprResults recognize( unsigned char* pixelData, int bytesPerPixel, int imgWidth, int imgHeight, std::vector<AlprRegionOfInterest> regionsOfInterest );
       AlprResults recognize( cv::Mat img );
       AlprResults recognize( cv::Mat img, std::vector<cv::Rect> regionsOfInterest );
 
       void applyRegionTemplate(AlprPlateResult* result, std::string region);
 
+      // Fills in the topN plates of a plate result from the post processor's results, and sets its best
+      // plate to the first one that matches a template, or else the first one
+      void addPlateCandidates(const std::vector<PPResult>& ppResults, PipelineData* pipeline_data, AlprPlateResult& plateResult);
+
       void setDetectRegion(bool detectRegion);
       void setTopN(int topn);
       void setDefaultRegion(std::string region);
+      void setIncludeCharacterDetails(bool includeCharacterDetails);
+      void setGrayscaleOnly(bool grayscaleOnly);
+      bool isGrayscaleOnly();
+
+      static std::string toJson( const AlprResults& results );
+      static std::string toJson( const AlprResults& results, const std::vector<AlprJsonField>& extraFields );
 
-      static std::string toJson( const AlprResults results );
+      // Serializes into the json buffer, replacing its contents.  Reusing the buffer avoids reallocating it.
+      // The extra fields are written at the top level, after the results.
+      static void toJson( const AlprResults& results, std::string& json,
+                          const std::vector<AlprJsonField>& extraFields = std::vector<AlprJsonField>() );
       static AlprResults fromJson(std::string json);
+
+      // Parses the results in a single pass, without building a tree.  Returns false and describes the
+      // problem in error when the JSON is malformed or misses a required field.
+      static bool fromJson(const std::string& json, AlprResults& results, std::string& error);
       static std::string getVersion();
 
-      static cJSON* createJsonObj(const AlprPlateResult* result);
+      static void writePlateJson(JsonWriter& writer, const AlprPlateResult& result);
+      static bool readPlateJson(JsonReader& reader, AlprPlateResult& result);
+      static bool readCandidateJson(JsonReader& reader, AlprPlate& candidate);
+      static bool readCharacterDetailsJson(JsonReader& reader, std::vector<AlprChar>& characterDetails);
       
       Config* config;
 
       bool isLoaded();
 
+      // The buffers recycled between frames, for measuring how many are still allocated per frame
+      FrameContext* getFrameContext();
+
     private:
 
       Detector* plateDetector;
@@ -103,12 +134,18 @@ namespace alpr
       OCR* ocr;
       PreWarp* prewarp;
 
+      // Recycles the buffers of the pipeline from one frame to the next
+      FrameContext frameContext;
+
       int topN;
       bool detectRegion;
       std::string defaultRegion;
+      bool includeCharacterDetails;
 
       cv::Mat getCharacterTransformMatrix(PipelineData* pipeline_data );
       std::vector<AlprCoordinate> getCharacterPoints(cv::Rect char_rect, cv::Mat transmtx);
+      // The 4 corners of each character region in the original image, 4 entries per region
+      void getCharacterCorners(PipelineData* pipeline_data, std::vector<AlprCoordinate>& corners);
       std::vector<cv::Rect> convertRects(std::vector<AlprRegionOfInterest> regionsOfInterest);
 
       std::vector<cv::Rect> intersectedRects(std::vector<cv::Rect> rects, const cv::Rect &overlap);
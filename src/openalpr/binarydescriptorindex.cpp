@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binarydescriptorindex.h"
+
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+namespace alpr
+{
+
+  // Number of set bits in each byte value
+  static const uchar bitCounts[256] =
+  {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8
+  };
+
+  static int hammingDistance(const uchar* a, const uchar* b, int bytes)
+  {
+    int distance = 0;
+    for (int i = 0; i < bytes; i++)
+      distance += bitCounts[a[i] ^ b[i]];
+    return distance;
+  }
+
+  static bool matchDistanceCompare(const DMatch& left, const DMatch& right)
+  {
+    if (left.distance != right.distance)
+      return left.distance < right.distance;
+    if (left.imgIdx != right.imgIdx)
+      return left.imgIdx < right.imgIdx;
+    return left.trainIdx < right.trainIdx;
+  }
+
+  BinaryDescriptorIndex::BinaryDescriptorIndex(int tableCount, int keyBits)
+  {
+    this->tableCount = tableCount;
+    this->keyBits = keyBits;
+    this->descriptorBytes = 0;
+    this->queryCount = 0;
+  }
+
+  BinaryDescriptorIndex::~BinaryDescriptorIndex()
+  {
+  }
+
+  int BinaryDescriptorIndex::size()
+  {
+    return descriptors.rows;
+  }
+
+  void BinaryDescriptorIndex::build(const vector<Mat>& trainDescriptors)
+  {
+    imageIndexes.clear();
+    trainIndexes.clear();
+    descriptors.release();
+
+    vector<Mat> rows;
+    for (unsigned int i = 0; i < trainDescriptors.size(); i++)
+    {
+      if (trainDescriptors[i].rows == 0)
+        continue;
+
+      rows.push_back(trainDescriptors[i]);
+      for (int r = 0; r < trainDescriptors[i].rows; r++)
+      {
+        imageIndexes.push_back(i);
+        trainIndexes.push_back(r);
+      }
+    }
+
+    if (rows.size() > 0)
+      vconcat(rows, descriptors);
+
+    descriptorBytes = descriptors.cols;
+    lastQuery.assign(descriptors.rows, -1);
+    queryCount = 0;
+
+    // The same bits are sampled every time, so matching is repeatable
+    RNG rng(0x4F414C50);
+    int totalBits = descriptorBytes * 8;
+    sampledBits.clear();
+    for (int t = 0; t < tableCount && totalBits >= keyBits; t++)
+    {
+      vector<int> bits;
+      while (bits.size() < keyBits)
+      {
+        int bit = rng.uniform(0, totalBits);
+        if (find(bits.begin(), bits.end(), bit) == bits.end())
+          bits.push_back(bit);
+      }
+      sampledBits.insert(sampledBits.end(), bits.begin(), bits.end());
+    }
+
+    int tables = sampledBits.size() / keyBits;
+    int bucketCount = 1 << keyBits;
+    bucketStarts.assign(tables, vector<int>(bucketCount + 1, 0));
+    bucketIds.assign(tables, vector<int>(descriptors.rows));
+
+    for (int t = 0; t < tables; t++)
+    {
+      vector<unsigned int> keys(descriptors.rows);
+      for (int id = 0; id < descriptors.rows; id++)
+      {
+        keys[id] = getKey(t, descriptors.ptr<uchar>(id));
+        bucketStarts[t][keys[id] + 1]++;
+      }
+
+      for (int k = 0; k < bucketCount; k++)
+        bucketStarts[t][k + 1] += bucketStarts[t][k];
+
+      vector<int> fill(bucketStarts[t].begin(), bucketStarts[t].end() - 1);
+      for (int id = 0; id < descriptors.rows; id++)
+        bucketIds[t][fill[keys[id]]++] = id;
+    }
+  }
+
+  unsigned int BinaryDescriptorIndex::getKey(int table, const uchar* descriptor)
+  {
+    const int* bits = &sampledBits[table * keyBits];
+
+    unsigned int key = 0;
+    for (int b = 0; b < keyBits; b++)
+      key |= ((descriptor[bits[b] >> 3] >> (bits[b] & 7)) & 1) << b;
+
+    return key;
+  }
+
+  void BinaryDescriptorIndex::radiusMatch(const Mat& queryDescriptors, vector<vector<DMatch> >& matches, float maxDistance)
+  {
+    matches.clear();
+    matches.resize(queryDescriptors.rows);
+
+    if (descriptors.rows == 0 || queryDescriptors.cols != descriptorBytes || queryDescriptors.type() != CV_8U)
+      return;
+
+    int tables = bucketStarts.size();
+    for (int q = 0; q < queryDescriptors.rows; q++)
+    {
+      const uchar* query = queryDescriptors.ptr<uchar>(q);
+      vector<DMatch>& queryMatches = matches[q];
+      queryCount++;
+
+      for (int t = 0; t < tables; t++)
+      {
+        unsigned int queryKey = getKey(t, query);
+
+        // Probe the query's own bucket, then every bucket one bit away
+        for (int probe = -1; probe < keyBits; probe++)
+        {
+          unsigned int key = probe < 0 ? queryKey : queryKey ^ (1u << probe);
+
+          for (int i = bucketStarts[t][key]; i < bucketStarts[t][key + 1]; i++)
+          {
+            int id = bucketIds[t][i];
+            if (lastQuery[id] == queryCount)
+              continue;
+            lastQuery[id] = queryCount;
+
+            float distance = (float) hammingDistance(query, descriptors.ptr<uchar>(id), descriptorBytes);
+            if (distance < maxDistance)
+              queryMatches.push_back(DMatch(q, trainIndexes[id], imageIndexes[id], distance));
+          }
+        }
+      }
+
+      sort(queryMatches.begin(), queryMatches.end(), matchDistanceCompare);
+    }
+  }
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_BINARYDESCRIPTORINDEX_H
+#define OPENALPR_BINARYDESCRIPTORINDEX_H
+
+#include <vector>
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/features2d/features2d.hpp"
+
+namespace alpr
+{
+
+  // Multi-probe locality sensitive hash index of binary descriptors (e.g., BRISK), for matching by
+  // Hamming distance.  Each table hashes a descriptor on a fixed random sample of its bits.  A query
+  // looks in the bucket of its own key and the buckets one bit away from it in every table, and only
+  // the descriptors found there are compared.
+  class BinaryDescriptorIndex
+  {
+    public:
+      BinaryDescriptorIndex(int tableCount = 12, int keyBits = 12);
+      virtual ~BinaryDescriptorIndex();
+
+      // Indexes the descriptors of the training images.  All must be CV_8U with the same number of columns.
+      void build(const std::vector<cv::Mat>& trainDescriptors);
+
+      // Same as DescriptorMatcher::radiusMatch: for each query descriptor, the indexed descriptors closer
+      // than maxDistance, nearest first.  Neighbors that share no bucket with the query are missed.
+      void radiusMatch(const cv::Mat& queryDescriptors, std::vector<std::vector<cv::DMatch> >& matches, float maxDistance);
+
+      int size();
+
+    private:
+      int tableCount;
+      int keyBits;
+      int descriptorBytes;
+
+      cv::Mat descriptors;
+      std::vector<int> imageIndexes;
+      std::vector<int> trainIndexes;
+
+      // The bits sampled by each table, keyBits per table
+      std::vector<int> sampledBits;
+
+      // Each table's buckets, stored as the descriptor ids sorted by key.  The ids of key k in table t
+      // are bucketIds[t][bucketStarts[t][k]] up to bucketStarts[t][k + 1].
+      std::vector<std::vector<int> > bucketStarts;
+      std::vector<std::vector<int> > bucketIds;
+
+      // Query number that last compared each descriptor, so a descriptor is only compared once per query
+      std::vector<int> lastQuery;
+      int queryCount;
+
+      unsigned int getKey(int table, const uchar* descriptor);
+  };
+
+}
+
+#endif // OPENALPR_BINARYDESCRIPTORINDEX_H
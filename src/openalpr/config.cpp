@@ -169,16 +169,53 @@ namespace alpr
     platesRoiHeight = getInt(ini, "", "plates_roi_height", 0);
 
     skipDetection = getBoolean(ini, "", "skip_detection", false);
+
+    grayscaleOnly = getBoolean(ini, "", "grayscale_only", false);
     
     prewarp = getString(ini, "", "prewarp", "");
+
+    std::string prewarpInterpolationString = getString(ini, "", "prewarp_interpolation", "linear");
+    std::transform(prewarpInterpolationString.begin(), prewarpInterpolationString.end(), prewarpInterpolationString.begin(), ::tolower);
+
+    if (prewarpInterpolationString.compare("nearest") == 0)
+      prewarpInterpolation = PREWARP_INTERPOLATION_NEAREST;
+    else if (prewarpInterpolationString.compare("linear") == 0)
+      prewarpInterpolation = PREWARP_INTERPOLATION_LINEAR;
+    else if (prewarpInterpolationString.compare("cubic") == 0)
+      prewarpInterpolation = PREWARP_INTERPOLATION_CUBIC;
+    else
+    {
+      std::cerr << "Invalid prewarp interpolation specified: " << prewarpInterpolationString << ".  Using default" << std::endl;
+      prewarpInterpolation = PREWARP_INTERPOLATION_LINEAR;
+    }
             
     maxPlateAngleDegrees = getInt(ini, "", "max_plate_angle_degrees", 15);
 
 
     ocrImagePercent = getFloat(ini, "", "ocr_img_size_percent", 100);
     stateIdImagePercent = getFloat(ini, "", "state_id_img_size_percent", 100);
+    stateIdDescriptorIndex = getBoolean(ini, "", "state_id_descriptor_index", false);
 
     ocrMinFontSize = getInt(ini, "", "ocr_min_font_point", 100);
+    ocrBatchCharacters = getBoolean(ini, "", "ocr_batch_characters", false);
+
+    std::string ocrBackendString = getString(ini, "", "ocr_backend", "tesseract");
+    std::transform(ocrBackendString.begin(), ocrBackendString.end(), ocrBackendString.begin(), ::tolower);
+
+    if (ocrBackendString.compare("tesseract") == 0)
+      ocrBackend = OCR_BACKEND_TESSERACT;
+    else if (ocrBackendString.compare("glyph") == 0)
+      ocrBackend = OCR_BACKEND_GLYPH;
+    else
+    {
+      std::cerr << "Invalid OCR backend specified: " << ocrBackendString << ".  Using default" << std::endl;
+      ocrBackend = OCR_BACKEND_TESSERACT;
+    }
+
+    ocrGlyphCacheSize = getInt(ini, "", "ocr_glyph_cache_size", 500);
+    ocrThreads = std::max(1, getInt(ini, "", "ocr_threads", 1));
+    ocrEarlyExitConfidence = getFloat(ini, "", "ocr_early_exit_confidence", 0);
+    ocrEarlyExitMargin = getFloat(ini, "", "ocr_early_exit_margin", 20);
 
     postProcessMinConfidence = getFloat(ini, "", "postprocess_min_confidence", 100);
     postProcessConfidenceSkipLevel = getFloat(ini, "", "postprocess_confidence_skip_level", 100);
@@ -278,6 +315,10 @@ namespace alpr
   {
     return this->runtimeBaseDir + "/ocr/";
   }
+  string Config::getGlyphClassifierFile()
+  {
+    return this->runtimeBaseDir + "/ocr/" + this->ocrLanguage + ".glyphs.yml";
+  }
 
 
 
@@ -63,7 +63,10 @@ namespace alpr
 
       bool skipDetection;
 
+      bool grayscaleOnly;
+
       std::string prewarp;
+      int prewarpInterpolation;
       
       int maxPlateAngleDegrees;
 
@@ -88,6 +91,7 @@ namespace alpr
 
       int stateIdImageWidthPx;
       int stateIdimageHeightPx;
+      bool stateIdDescriptorIndex;
 
       float charAnalysisMinPercent;
       float charAnalysisHeightRange;
@@ -103,6 +107,12 @@ namespace alpr
 
       std::string ocrLanguage;
       int ocrMinFontSize;
+      bool ocrBatchCharacters;
+      int ocrBackend;
+      int ocrGlyphCacheSize;
+      int ocrThreads;
+      float ocrEarlyExitConfidence;
+      float ocrEarlyExitMargin;
 
       float postProcessMinConfidence;
       float postProcessConfidenceSkipLevel;
@@ -130,6 +140,7 @@ namespace alpr
       std::string getCascadeRuntimeDir();
       std::string getPostProcessRuntimeDir();
       std::string getTessdataPrefix();
+      std::string getGlyphClassifierFile();
 
     private:
     
@@ -155,5 +166,19 @@ namespace alpr
     DETECTOR_MORPH_CPU=2
   };
 
+  enum OCR_BACKEND_TYPE
+  {
+    OCR_BACKEND_TESSERACT=0,
+    OCR_BACKEND_GLYPH=1
+  };
+
+  // Same values as OpenCV's INTER_NEAREST, INTER_LINEAR and INTER_CUBIC
+  enum PREWARP_INTERPOLATION_TYPE
+  {
+    PREWARP_INTERPOLATION_NEAREST=0,
+    PREWARP_INTERPOLATION_LINEAR=1,
+    PREWARP_INTERPOLATION_CUBIC=2
+  };
+
 }
 #endif // OPENALPR_CONFIG_H
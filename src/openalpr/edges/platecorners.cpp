@@ -25,6 +25,31 @@ using namespace std;
 namespace alpr
 {
 
+  // Weight ids for the horizontal/vertical scoring.  The names are only used for debug output
+  enum PlateCornerWeight
+  {
+    WEIGHT_LINE_CONFIDENCE,
+    WEIGHT_MISSING_SEGMENT_PENALTY_VERTICAL,
+    WEIGHT_MISSING_SEGMENT_PENALTY_HORIZONTAL,
+    WEIGHT_PLATEHEIGHT,
+    WEIGHT_TOP_BOTTOM_SPACE_VS_CHARHEIGHT,
+    WEIGHT_ANGLE_MATCHES_LPCHARS,
+    WEIGHT_DISTANCE_VERTICAL,
+    PLATE_CORNER_WEIGHT_COUNT
+  };
+
+  static const char* const PLATE_CORNER_WEIGHT_NAMES[PLATE_CORNER_WEIGHT_COUNT] = {
+    "SCORING_LINE_CONFIDENCE_WEIGHT",
+    "SCORING_MISSING_SEGMENT_PENALTY_VERTICAL",
+    "SCORING_MISSING_SEGMENT_PENALTY_HORIZONTAL",
+    "SCORING_PLATEHEIGHT_WEIGHT",
+    "SCORING_TOP_BOTTOM_SPACE_VS_CHARHEIGHT_WEIGHT",
+    "SCORING_ANGLE_MATCHES_LPCHARS_WEIGHT",
+    "SCORING_DISTANCE_WEIGHT_VERTICAL"
+  };
+
+  typedef FixedScoreKeeper<PLATE_CORNER_WEIGHT_COUNT> PlateCornerScoreKeeper;
+
   PlateCorners::PlateCorners(Mat inputImage, PlateLines* plateLines, PipelineData* pipelineData, vector<TextLine> textLines) :
       tlc(textLines)
   {
@@ -40,6 +65,11 @@ namespace alpr
     this->bestHorizontalScore = 9999999999999;
     this->bestVerticalScore = 9999999999999;
 
+    float charHeightToPlateWidthRatio = pipelineData->config->plateWidthMM / pipelineData->config->charHeightMM;
+    this->idealPixelWidth = tlc.charHeight *  (charHeightToPlateWidthRatio * 1.03);	// Add 3% so we don't clip any characters
+
+    float charHeightToPlateHeightRatio = pipelineData->config->plateHeightMM / pipelineData->config->charHeightMM;
+    this->idealPixelHeight = tlc.charHeight *  charHeightToPlateHeightRatio;
 
   }
 
@@ -58,12 +88,25 @@ namespace alpr
     int horizontalLines = this->plateLines->horizontalLines.size();
     int verticalLines = this->plateLines->verticalLines.size();
 
+    // A line can only be used as a top (or left) edge if it is above (or left of) the text, and
+    // as a bottom (or right) edge if it is below (or right of) the text.  Classify each line once
+    // so that only the pairs that can pass that test are scored.
+    vector<int> horizontalSide(horizontalLines);
+    for (int h = 0; h < horizontalLines; h++)
+      horizontalSide[h] = tlc.isAboveText(this->plateLines->horizontalLines[h].line);
+
+    vector<int> verticalSide(verticalLines);
+    for (int v = 0; v < verticalLines; v++)
+      verticalSide[v] = tlc.isLeftOfText(this->plateLines->verticalLines[v].line);
+
     // layout horizontal lines
     for (int h1 = NO_LINE; h1 < horizontalLines; h1++)
     {
+      if (h1 != NO_LINE && horizontalSide[h1] < 1) continue;
+
       for (int h2 = NO_LINE; h2 < horizontalLines; h2++)
       {
-        if (h1 == h2 && h1 != NO_LINE) continue;
+        if (h2 != NO_LINE && horizontalSide[h2] > -1) continue;
 
         this->scoreHorizontals(h1, h2);
       }
@@ -72,9 +115,11 @@ namespace alpr
     // layout vertical lines
     for (int v1 = NO_LINE; v1 < verticalLines; v1++)
     {
+      if (v1 != NO_LINE && verticalSide[v1] < 1) continue;
+
       for (int v2 = NO_LINE; v2 < verticalLines; v2++)
       {
-        if (v1 == v2 && v1 != NO_LINE) continue;
+        if (v2 != NO_LINE && verticalSide[v2] > -1) continue;
 
         this->scoreVerticals(v1, v2);
       }
@@ -130,17 +175,15 @@ namespace alpr
     return corners;
   }
 
+  // Every score component is non-negative, so the running total never decreases as components
+  // are added.  Once it reaches the best score so far, the pairing cannot win and is abandoned.
   void PlateCorners::scoreVerticals(int v1, int v2)
   {
-    ScoreKeeper scoreKeeper;
+    PlateCornerScoreKeeper scoreKeeper(PLATE_CORNER_WEIGHT_NAMES);
 
     LineSegment left;
     LineSegment right;
 
-
-    float charHeightToPlateWidthRatio = pipelineData->config->plateWidthMM / pipelineData->config->charHeightMM;
-    float idealPixelWidth = tlc.charHeight *  (charHeightToPlateWidthRatio * 1.03);	// Add 3% so we don't clip any characters
-
     float confidenceDiff = 0;
     float missingSegmentPenalty = 0;
 
@@ -176,8 +219,11 @@ namespace alpr
       confidenceDiff += (1.0 - this->plateLines->verticalLines[v1].confidence);
     }
 
-    scoreKeeper.setScore("SCORING_LINE_CONFIDENCE_WEIGHT", confidenceDiff, SCORING_LINE_CONFIDENCE_WEIGHT);
-    scoreKeeper.setScore("SCORING_MISSING_SEGMENT_PENALTY_VERTICAL", missingSegmentPenalty, SCORING_MISSING_SEGMENT_PENALTY_VERTICAL);
+    scoreKeeper.setScore(WEIGHT_LINE_CONFIDENCE, confidenceDiff, SCORING_LINE_CONFIDENCE_WEIGHT);
+    scoreKeeper.setScore(WEIGHT_MISSING_SEGMENT_PENALTY_VERTICAL, missingSegmentPenalty, SCORING_MISSING_SEGMENT_PENALTY_VERTICAL);
+
+    if (scoreKeeper.getTotal() >= this->bestVerticalScore)
+      return;
 
     // Make sure that the left and right lines are to the left and right of our text 
     // area
@@ -192,7 +238,10 @@ namespace alpr
     float perpendicularCharAngle = tlc.charAngle - 90;
     float charanglediff = abs(perpendicularCharAngle - left.angle) + abs(perpendicularCharAngle - right.angle);
 
-    scoreKeeper.setScore("SCORING_ANGLE_MATCHES_LPCHARS_WEIGHT", charanglediff, SCORING_ANGLE_MATCHES_LPCHARS_WEIGHT);
+    scoreKeeper.setScore(WEIGHT_ANGLE_MATCHES_LPCHARS, charanglediff, SCORING_ANGLE_MATCHES_LPCHARS_WEIGHT);
+
+    if (scoreKeeper.getTotal() >= this->bestVerticalScore)
+      return;
 
     //////////////////////////////////////////////////////////////////////////
     // SCORE the shape wrt character position and height relative to position
@@ -212,7 +261,7 @@ namespace alpr
     // normalize for image width
     plateDistance = plateDistance / ((float)inputImage.cols);
     
-    scoreKeeper.setScore("SCORING_DISTANCE_WEIGHT_VERTICAL", plateDistance, SCORING_DISTANCE_WEIGHT_VERTICAL);
+    scoreKeeper.setScore(WEIGHT_DISTANCE_VERTICAL, plateDistance, SCORING_DISTANCE_WEIGHT_VERTICAL);
 
     float score = scoreKeeper.getTotal();
 
@@ -237,14 +286,11 @@ namespace alpr
   void PlateCorners::scoreHorizontals(int h1, int h2)
   {
 
-    ScoreKeeper scoreKeeper;
+    PlateCornerScoreKeeper scoreKeeper(PLATE_CORNER_WEIGHT_NAMES);
 
     LineSegment top;
     LineSegment bottom;
 
-    float charHeightToPlateHeightRatio = pipelineData->config->plateHeightMM / pipelineData->config->charHeightMM;
-    float idealPixelHeight = tlc.charHeight *  charHeightToPlateHeightRatio;
-
     float confidenceDiff = 0;
     float missingSegmentPenalty = 0;
 
@@ -281,8 +327,11 @@ namespace alpr
       confidenceDiff += (1.0 - this->plateLines->horizontalLines[h1].confidence);
     }
 
-    scoreKeeper.setScore("SCORING_MISSING_SEGMENT_PENALTY_HORIZONTAL", missingSegmentPenalty, SCORING_MISSING_SEGMENT_PENALTY_HORIZONTAL);
-    //scoreKeeper.setScore("SCORING_LINE_CONFIDENCE_WEIGHT", confidenceDiff, SCORING_LINE_CONFIDENCE_WEIGHT);
+    scoreKeeper.setScore(WEIGHT_MISSING_SEGMENT_PENALTY_HORIZONTAL, missingSegmentPenalty, SCORING_MISSING_SEGMENT_PENALTY_HORIZONTAL);
+    //scoreKeeper.setScore(WEIGHT_LINE_CONFIDENCE, confidenceDiff, SCORING_LINE_CONFIDENCE_WEIGHT);
+
+    if (scoreKeeper.getTotal() >= this->bestHorizontalScore)
+      return;
 
 
     // Make sure that the top and bottom lines are above and below
@@ -307,7 +356,10 @@ namespace alpr
     float idealHeightRatio = (pipelineData->config->charHeightMM / pipelineData->config->plateHeightMM);
     float heightRatioDiff = abs(heightRatio - idealHeightRatio);
 
-    scoreKeeper.setScore("SCORING_PLATEHEIGHT_WEIGHT", heightRatioDiff, SCORING_PLATEHEIGHT_WEIGHT);
+    scoreKeeper.setScore(WEIGHT_PLATEHEIGHT, heightRatioDiff, SCORING_PLATEHEIGHT_WEIGHT);
+
+    if (scoreKeeper.getTotal() >= this->bestHorizontalScore)
+      return;
 
     //////////////////////////////////////////////////////////////////////////
     // SCORE the middliness of the stuff.  We want our top and bottom line to have the characters right towards the middle
@@ -325,7 +377,7 @@ namespace alpr
     float middleScore = abs(topDistanceFromMiddle - idealDistanceFromMiddle) / idealDistanceFromMiddle;
     middleScore +=      abs(bottomDistanceFromMiddle - idealDistanceFromMiddle) / idealDistanceFromMiddle;
 
-    scoreKeeper.setScore("SCORING_TOP_BOTTOM_SPACE_VS_CHARHEIGHT_WEIGHT", middleScore, SCORING_TOP_BOTTOM_SPACE_VS_CHARHEIGHT_WEIGHT);
+    scoreKeeper.setScore(WEIGHT_TOP_BOTTOM_SPACE_VS_CHARHEIGHT, middleScore, SCORING_TOP_BOTTOM_SPACE_VS_CHARHEIGHT_WEIGHT);
 
 
     //////////////////////////////////////////////////////////////
@@ -334,7 +386,7 @@ namespace alpr
 
     float charanglediff = abs(tlc.charAngle - top.angle) + abs(tlc.charAngle - bottom.angle);
 
-    scoreKeeper.setScore("SCORING_ANGLE_MATCHES_LPCHARS_WEIGHT", charanglediff, SCORING_ANGLE_MATCHES_LPCHARS_WEIGHT);
+    scoreKeeper.setScore(WEIGHT_ANGLE_MATCHES_LPCHARS, charanglediff, SCORING_ANGLE_MATCHES_LPCHARS_WEIGHT);
 
     if (pipelineData->config->debugPlateCorners)
     {
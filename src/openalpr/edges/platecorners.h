@@ -61,6 +61,9 @@ namespace alpr
       std::vector<TextLine> textLines;
       TextLineCollection tlc;
 
+      float idealPixelWidth;
+      float idealPixelHeight;
+
       float bestHorizontalScore;
       float bestVerticalScore;
       LineSegment bestTop;
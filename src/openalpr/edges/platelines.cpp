@@ -33,6 +33,9 @@ namespace alpr
 
     this->debug = pipelineData->config->debugPlateLines;
 
+    this->horizontalSensitivity = pipelineData->config->plateLinesSensitivityHorizontal;
+    this->verticalSensitivity = pipelineData->config->plateLinesSensitivityVertical;
+
     if (debug)
       cout << "PlateLines constructor" << endl;
   }
@@ -143,17 +146,14 @@ namespace alpr
     if (this->debug)
       cout << "PlateLines::getLines" << endl;
 
-    static int HORIZONTAL_SENSITIVITY = pipelineData->config->plateLinesSensitivityHorizontal;
-    static int VERTICAL_SENSITIVITY = pipelineData->config->plateLinesSensitivityVertical;
-
     vector<Vec2f> allLines;
     vector<PlateLine> filteredLines;
 
     int sensitivity;
     if (vertical)
-      sensitivity = VERTICAL_SENSITIVITY * (1.0 / sensitivityMultiplier);
+      sensitivity = verticalSensitivity * (1.0 / sensitivityMultiplier);
     else
-      sensitivity = HORIZONTAL_SENSITIVITY * (1.0 / sensitivityMultiplier);
+      sensitivity = horizontalSensitivity * (1.0 / sensitivityMultiplier);
 
     HoughLines( edges, allLines, 1, CV_PI/180, sensitivity, 0, 0 );
 
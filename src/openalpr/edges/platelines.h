@@ -55,6 +55,9 @@ namespace alpr
       PipelineData* pipelineData;
       bool debug;
 
+      int horizontalSensitivity;
+      int verticalSensitivity;
+
       cv::Mat customGrayscaleConversion(cv::Mat src);
       void findLines(cv::Mat inputImage);
       std::vector<PlateLine> getLines(cv::Mat edges, float sensitivityMultiplier, bool vertical);
@@ -39,6 +39,12 @@ namespace alpr
     weights.push_back(weight);
   }
 
+  void ScoreKeeper::clear() {
+    weight_ids.clear();
+    scores.clear();
+    weights.clear();
+  }
+
 
   float ScoreKeeper::getTotal() {
 
@@ -21,6 +21,8 @@
 #define	OPENALPR_SCOREKEEPER_H
 
 #include <string>
+#include <vector>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 
@@ -34,6 +36,9 @@ namespace alpr
 
     void setScore(std::string weight_id, float score, float weight);
 
+    // Removes all scores, keeping the storage for the next plate
+    void clear();
+
     float getTotal();
     int size();
 
@@ -48,6 +53,77 @@ namespace alpr
 
   };
 
+  // Allocation-free variant of ScoreKeeper for scoring loops.
+  // Weight ids are compile-time constants that index into a table of names,
+  // which is only used for debug output.
+  template <int CAPACITY>
+  class FixedScoreKeeper {
+  public:
+    FixedScoreKeeper(const char* const* weight_names) :
+      weight_names(weight_names), count(0)
+    {
+    }
+
+    void setScore(int weight_id, float score, float weight)
+    {
+      // Assume that we never set this value twice
+      weight_ids[count] = weight_id;
+      scores[count] = score;
+      weights[count] = weight;
+      count++;
+    }
+
+    // Scores are summed in the order they were set
+    float getTotal() const
+    {
+      float score = 0;
+
+      for (int i = 0; i < count; i++)
+        score += scores[i] * weights[i];
+
+      return score;
+    }
+
+    int size() const
+    {
+      return count;
+    }
+
+    void printDebugScores() const
+    {
+      int longest_weight_id = 0;
+      for (int i = 0; i < count; i++)
+      {
+        int length = strlen(weight_names[weight_ids[i]]);
+        if (length > longest_weight_id)
+          longest_weight_id = length;
+      }
+
+      float total = getTotal();
+
+      for (int i = 0; i < count; i++)
+      {
+        float percent_of_total = (scores[i] * weights[i]) / total * 100;
+
+        std::cout << " - " << std::setw(longest_weight_id + 1) << std::left << weight_names[weight_ids[i]] <<
+                " Weighted Score: " << std::setw(10) << std::left << (scores[i] * weights[i]) <<
+                " Orig Score: " << std::setw(10) << std::left << scores[i] <<
+                " (" << percent_of_total << "% of total)" << std::endl;
+      }
+
+      std::cout << "Total: " << total << std::endl;
+    }
+
+  private:
+
+    const char* const* weight_names;
+
+    int weight_ids[CAPACITY];
+    float scores[CAPACITY];
+    float weights[CAPACITY];
+    int count;
+  };
+
 }
 
 #endif	/* OPENALPR_SCOREKEEPER_H */
@@ -29,6 +29,13 @@ namespace alpr
   //const int DEFAULT_TRAINING_FEATURES = 305;
   const float MAX_DISTANCE_TO_MATCH = 100.0f;
 
+  // Feature extraction parameters.  These are part of the keypoint cache signature.
+  const int FAST_THRESHOLD = 10;
+  const bool FAST_NONMAX_SUPPRESSION = true;
+  const int BRISK_THRESHOLD = 10;
+  const int BRISK_OCTAVES = 1;
+  const float BRISK_PATTERN_SCALE = 0.9f;
+
   FeatureMatcher::FeatureMatcher(Config* config)
   {
     this->config = config;
@@ -38,8 +45,8 @@ namespace alpr
 
     //this->descriptorMatcher = DescriptorMatcher::create( "FlannBased" );
 
-    this->detector = new FastFeatureDetector(10, true);
-    this->extractor = new BRISK(10, 1, 0.9);
+    this->detector = new FastFeatureDetector(FAST_THRESHOLD, FAST_NONMAX_SUPPRESSION);
+    this->extractor = new BRISK(BRISK_THRESHOLD, BRISK_OCTAVES, BRISK_PATTERN_SCALE);
   }
 
   FeatureMatcher::~FeatureMatcher()
@@ -73,7 +80,10 @@ namespace alpr
   {
     vector<vector<DMatch> > matchesKnn;
 
-    this->descriptorMatcher->radiusMatch(queryDescriptors, matchesKnn, MAX_DISTANCE_TO_MATCH);
+    if (config->stateIdDescriptorIndex)
+      descriptorIndex.radiusMatch(queryDescriptors, matchesKnn, MAX_DISTANCE_TO_MATCH);
+    else
+      this->descriptorMatcher->radiusMatch(queryDescriptors, matchesKnn, MAX_DISTANCE_TO_MATCH);
 
     vector<DMatch> tempMatches;
     _surfStyleMatching(queryDescriptors, matchesKnn, tempMatches);
@@ -240,48 +250,130 @@ namespace alpr
 
     if (DirectoryExists(country_dir.c_str()))
     {
+      vector<string> plateFiles = getTrainingFiles(country_dir);
+      string signature = getRecognitionSetSignature(country_dir, plateFiles);
+      string cacheFile = getRecognitionCacheFile(country);
+
+      vector<KeypointCacheEntry> entries;
+      if (readKeypointCache(cacheFile, signature, entries) == false)
+      {
+        if (this->config->debugStateId)
+          cout << "Keypoint cache " << cacheFile << " is missing or stale.  Extracting keypoints from the images" << endl;
+
+        extractTrainingPlates(country_dir, plateFiles, entries);
+
+        if (writeKeypointCache(cacheFile, signature, entries) == false && this->config->debugStateId)
+          cout << "Unable to write keypoint cache " << cacheFile << endl;
+      }
+
       vector<Mat> trainImages;
-      vector<string> plateFiles = getFilesInDir(country_dir.c_str());
+      for (unsigned int i = 0; i < entries.size(); i++)
+      {
+        billMapping.push_back(entries[i].name.substr(0, 2));
+        trainImages.push_back(entries[i].descriptors);
+        trainingImgKeypoints.push_back(entries[i].keypoints);
+      }
 
-      for (unsigned int i = 0; i < plateFiles.size(); i++)
+      if (config->stateIdDescriptorIndex)
+      {
+        descriptorIndex.build(trainImages);
+      }
+      else
       {
-        if (hasEnding(plateFiles[i], ".jpg") == false)
-          continue;
+        this->descriptorMatcher->add(trainImages);
+        this->descriptorMatcher->train();
+      }
 
-        string fullpath = country_dir + plateFiles[i];
-        Mat img = imread( fullpath );
+      return true;
+    }
 
-        // convert to gray and resize to the size of the templates
-        cvtColor(img, img, CV_BGR2GRAY);
-        resize(img, img, getSizeMaintainingAspect(img, config->stateIdImageWidthPx, config->stateIdimageHeightPx));
+    return false;
+  }
 
-        if( img.empty() )
-        {
-          cout << "Can not read images" << endl;
-          return -1;
-        }
+  bool FeatureMatcher::writeRecognitionCache(string country)
+  {
+    std::ostringstream out;
+    out << config->getKeypointsRuntimeDir() << "/" << country << "/";
+    string country_dir = out.str();
 
-        Mat descriptors;
+    if (DirectoryExists(country_dir.c_str()) == false)
+      return false;
 
-        vector<KeyPoint> keypoints;
-        detector->detect( img, keypoints );
-        extractor->compute(img, keypoints, descriptors);
+    vector<string> plateFiles = getTrainingFiles(country_dir);
 
-        if (descriptors.cols > 0)
-        {
-          billMapping.push_back(plateFiles[i].substr(0, 2));
-          trainImages.push_back(descriptors);
-          trainingImgKeypoints.push_back(keypoints);
-        }
-      }
+    vector<KeypointCacheEntry> entries;
+    extractTrainingPlates(country_dir, plateFiles, entries);
+
+    return writeKeypointCache(getRecognitionCacheFile(country), getRecognitionSetSignature(country_dir, plateFiles), entries);
+  }
 
-      this->descriptorMatcher->add(trainImages);
-      this->descriptorMatcher->train();
+  string FeatureMatcher::getRecognitionCacheFile(string country)
+  {
+    return config->getKeypointsRuntimeDir() + "/" + country + ".keypoints.bin";
+  }
 
-      return true;
+  // The training images, sorted so the plates are always loaded in the same order
+  vector<string> FeatureMatcher::getTrainingFiles(string country_dir)
+  {
+    vector<string> allFiles = getFilesInDir(country_dir.c_str());
+
+    vector<string> plateFiles;
+    for (unsigned int i = 0; i < allFiles.size(); i++)
+    {
+      if (hasEnding(allFiles[i], ".jpg"))
+        plateFiles.push_back(allFiles[i]);
     }
 
-    return false;
+    sort(plateFiles.begin(), plateFiles.end(), stringCompare);
+    return plateFiles;
+  }
+
+  // Identifies the extractor parameters and the training images (name, size and modification time) that a keypoint cache was built from
+  string FeatureMatcher::getRecognitionSetSignature(string country_dir, const vector<string>& plateFiles)
+  {
+    std::ostringstream signature;
+    signature << "fast " << FAST_THRESHOLD << " " << FAST_NONMAX_SUPPRESSION;
+    signature << " brisk " << BRISK_THRESHOLD << " " << BRISK_OCTAVES << " " << BRISK_PATTERN_SCALE;
+    signature << " size " << config->stateIdImageWidthPx << "x" << config->stateIdimageHeightPx;
+    signature << " opencv " << CV_VERSION << endl;
+
+    for (unsigned int i = 0; i < plateFiles.size(); i++)
+    {
+      string fullpath = country_dir + plateFiles[i];
+      ifstream file(fullpath.c_str(), ios::in | ios::binary | ios::ate);
+      signature << plateFiles[i] << " " << (file.is_open() ? (long) file.tellg() : -1L) << " " << (long) getFileModificationTime(fullpath) << endl;
+    }
+
+    return signature.str();
+  }
+
+  void FeatureMatcher::extractTrainingPlates(string country_dir, const vector<string>& plateFiles, vector<KeypointCacheEntry>& entries)
+  {
+    entries.clear();
+
+    for (unsigned int i = 0; i < plateFiles.size(); i++)
+    {
+      string fullpath = country_dir + plateFiles[i];
+      Mat img = imread( fullpath );
+
+      if( img.empty() )
+      {
+        cout << "Can not read image " << fullpath << endl;
+        continue;
+      }
+
+      // convert to gray and resize to the size of the templates
+      cvtColor(img, img, CV_BGR2GRAY);
+      resize(img, img, getSizeMaintainingAspect(img, config->stateIdImageWidthPx, config->stateIdimageHeightPx));
+
+      KeypointCacheEntry entry;
+      entry.name = plateFiles[i];
+      detector->detect( img, entry.keypoints );
+      extractor->compute(img, entry.keypoints, entry.descriptors);
+
+      if (entry.descriptors.cols > 0)
+        entries.push_back(entry);
+    }
   }
 
   RecognitionResult FeatureMatcher::recognize( const Mat& queryImg, bool drawOnImage, Mat* outputImage,
@@ -29,6 +29,8 @@
 #include "constants.h"
 #include "utility.h"
 #include "config.h"
+#include "keypointcache.h"
+#include "binarydescriptorindex.h"
 
 namespace alpr
 {
@@ -50,8 +52,15 @@ namespace alpr
       RecognitionResult recognize( const cv::Mat& queryImg, bool drawOnImage, cv::Mat* outputImage,
                                    bool debug_on, std::vector<int> debug_matches_array );
 
+      // Loads the country's training plates from the keypoint cache.  If the cache is missing or stale,
+      // the keypoints are extracted from the images and the cache is rewritten.
       bool loadRecognitionSet(std::string country);
 
+      // Extracts the keypoints from the country's training plate images and writes the keypoint cache
+      bool writeRecognitionCache(std::string country);
+
+      std::string getRecognitionCacheFile(std::string country);
+
       bool isLoaded();
 
       int numTrainingElements();
@@ -60,11 +69,18 @@ namespace alpr
       Config* config;
 
       cv::Ptr<cv::DescriptorMatcher> descriptorMatcher;
+
+      // Used instead of the brute force matcher when stateIdDescriptorIndex is set
+      BinaryDescriptorIndex descriptorIndex;
       cv::Ptr<cv::FastFeatureDetector> detector;
       cv::Ptr<cv::BRISK> extractor;
 
       std::vector<std::vector<cv::KeyPoint> > trainingImgKeypoints;
 
+      std::vector<std::string> getTrainingFiles(std::string country_dir);
+      std::string getRecognitionSetSignature(std::string country_dir, const std::vector<std::string>& plateFiles);
+      void extractTrainingPlates(std::string country_dir, const std::vector<std::string>& plateFiles, std::vector<KeypointCacheEntry>& entries);
+
       void _surfStyleMatching(const cv::Mat& queryDescriptors, std::vector<std::vector<cv::DMatch> > matchesKnn, std::vector<cv::DMatch>& matches12);
 
       void crisscrossFiltering(const std::vector<cv::KeyPoint> queryKeypoints, const std::vector<cv::DMatch> inputMatches, std::vector<cv::DMatch> &outputMatches);
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "framecontext.h"
+
+using namespace cv;
+using namespace std;
+
+namespace alpr
+{
+
+  FrameContext::FrameContext()
+  {
+    this->pipelineData = NULL;
+    this->allocationCount = 0;
+  }
+
+  FrameContext::~FrameContext()
+  {
+    delete pipelineData;
+  }
+
+  Mat FrameContext::convertToGray(Mat img)
+  {
+    if (img.channels() <= 2)
+      return img;
+
+    if (grayBuffer.size() != img.size() || grayBuffer.type() != CV_8U)
+      allocationCount++;
+
+    cvtColor(img, grayBuffer, CV_BGR2GRAY);
+
+    return grayBuffer;
+  }
+
+  PipelineData* FrameContext::beginPlate(Mat colorImage, Mat grayImage, Rect regionOfInterest, Config* config)
+  {
+    if (pipelineData == NULL)
+    {
+      pipelineData = new PipelineData(colorImage, grayImage, regionOfInterest, config);
+      allocationCount++;
+    }
+
+    pipelineData->reset(colorImage, grayImage, regionOfInterest, config);
+
+    return pipelineData;
+  }
+
+  void FrameContext::endFrame()
+  {
+    plateQueue.clear();
+
+    if (pipelineData != NULL)
+      pipelineData->releaseImages();
+  }
+
+  int FrameContext::getAllocationCount()
+  {
+    if (pipelineData == NULL)
+      return allocationCount;
+
+    return allocationCount + pipelineData->scratch.getAllocationCount();
+  }
+
+  void FrameContext::resetAllocationCount()
+  {
+    allocationCount = 0;
+
+    if (pipelineData != NULL)
+      pipelineData->scratch.resetAllocationCount();
+  }
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_FRAMECONTEXT_H
+#define OPENALPR_FRAMECONTEXT_H
+
+#include <vector>
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include "config.h"
+#include "pipeline_data.h"
+#include "detection/detector.h"
+
+namespace alpr
+{
+
+  // Buffers that are kept from one frame to the next.  A single pipeline data is reset for each
+  // plate instead of being constructed, and its crops, thresholds and scratch images keep their
+  // memory.  Once a stream of frames of the same size has warmed it up, processing a frame no longer
+  // allocates any of these buffers.
+  class FrameContext
+  {
+
+    public:
+      FrameContext();
+      virtual ~FrameContext();
+
+      // Returns the frame in grayscale, converted into a recycled buffer.  A frame that is already
+      // gray is returned as is.
+      cv::Mat convertToGray(cv::Mat img);
+
+      // Returns the pipeline data, reset for the plate region.  It is only valid until the next call.
+      PipelineData* beginPlate(cv::Mat colorImage, cv::Mat grayImage, cv::Rect regionOfInterest, Config* config);
+
+      // Drops the references to the frame, keeping the buffers for the next one
+      void endFrame();
+
+      // Plate regions waiting to be analyzed.  They point into the detected regions of the current frame.
+      std::vector<const PlateRegion*> plateQueue;
+
+      // Number of buffer (re)allocations since construction or the last reset
+      int getAllocationCount();
+      void resetAllocationCount();
+
+    private:
+      cv::Mat grayBuffer;
+      PipelineData* pipelineData;
+
+      int allocationCount;
+  };
+
+}
+
+#endif // OPENALPR_FRAMECONTEXT_H
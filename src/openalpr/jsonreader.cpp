@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jsonreader.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sstream>
+
+using namespace std;
+
+namespace alpr
+{
+
+  namespace
+  {
+    // Deeper documents are rejected rather than risk running out of stack while skipping them
+    const unsigned int JSON_MAX_DEPTH = 64;
+
+    // Integers with at most this many digits are exact in a double, and are parsed without strtod
+    const int JSON_MAX_FAST_INTEGER_DIGITS = 15;
+
+    bool isDigit(char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    bool readHex4(const char* pos, unsigned int& value)
+    {
+      value = 0;
+      for (int i = 0; i < 4; i++)
+      {
+        char c = pos[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+          value |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+          value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+          value |= c - 'A' + 10;
+        else
+          return false;
+      }
+      return true;
+    }
+
+    void appendUtf8(string& output, unsigned int codepoint)
+    {
+      if (codepoint < 0x80)
+      {
+        output.push_back((char) codepoint);
+      }
+      else if (codepoint < 0x800)
+      {
+        output.push_back((char) (0xC0 | (codepoint >> 6)));
+        output.push_back((char) (0x80 | (codepoint & 0x3F)));
+      }
+      else if (codepoint < 0x10000)
+      {
+        output.push_back((char) (0xE0 | (codepoint >> 12)));
+        output.push_back((char) (0x80 | ((codepoint >> 6) & 0x3F)));
+        output.push_back((char) (0x80 | (codepoint & 0x3F)));
+      }
+      else
+      {
+        output.push_back((char) (0xF0 | (codepoint >> 18)));
+        output.push_back((char) (0x80 | ((codepoint >> 12) & 0x3F)));
+        output.push_back((char) (0x80 | ((codepoint >> 6) & 0x3F)));
+        output.push_back((char) (0x80 | (codepoint & 0x3F)));
+      }
+    }
+  }
+
+  JsonReader::JsonReader(const char* json, size_t length)
+  {
+    this->json = json;
+    this->pos = json;
+    this->end = json + length;
+  }
+
+  bool JsonReader::hasError() const
+  {
+    return error.size() > 0;
+  }
+
+  string JsonReader::getError() const
+  {
+    return error;
+  }
+
+  bool JsonReader::fail(string message)
+  {
+    // Only the first error is kept, the ones after it are usually caused by it
+    if (!hasError())
+    {
+      stringstream ss;
+      ss << message << " at offset " << (pos - json);
+      error = ss.str();
+    }
+
+    return false;
+  }
+
+  void JsonReader::skipWhitespace()
+  {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+      pos++;
+  }
+
+  bool JsonReader::expect(char c, const char* what)
+  {
+    if (hasError())
+      return false;
+
+    skipWhitespace();
+    if (pos < end && *pos == c)
+    {
+      pos++;
+      return true;
+    }
+
+    return fail(string("Expected ") + what);
+  }
+
+  bool JsonReader::beginObject()
+  {
+    if (firstValue.size() >= JSON_MAX_DEPTH)
+      return fail("Too deeply nested");
+
+    if (!expect('{', "an object"))
+      return false;
+
+    firstValue.push_back(true);
+    return true;
+  }
+
+  bool JsonReader::beginArray()
+  {
+    if (firstValue.size() >= JSON_MAX_DEPTH)
+      return fail("Too deeply nested");
+
+    if (!expect('[', "an array"))
+      return false;
+
+    firstValue.push_back(true);
+    return true;
+  }
+
+  bool JsonReader::beginNext(char close)
+  {
+    if (hasError())
+      return false;
+
+    if (firstValue.size() == 0)
+      return fail("No object or array is open");
+
+    skipWhitespace();
+    if (pos < end && *pos == close)
+    {
+      pos++;
+      firstValue.pop_back();
+      return false;
+    }
+
+    if (firstValue.back())
+    {
+      firstValue.back() = false;
+      return true;
+    }
+
+    return expect(',', "a comma");
+  }
+
+  bool JsonReader::nextKey(string& name)
+  {
+    if (!beginNext('}'))
+      return false;
+
+    return readString(name) && expect(':', "a colon");
+  }
+
+  bool JsonReader::nextElement()
+  {
+    return beginNext(']');
+  }
+
+  bool JsonReader::readNumber(double& value)
+  {
+    if (hasError())
+      return false;
+
+    skipWhitespace();
+    const char* start = pos;
+
+    bool negative = false;
+    if (pos < end && *pos == '-')
+    {
+      negative = true;
+      pos++;
+    }
+
+    const char* digits = pos;
+    if (pos >= end || !isDigit(*pos))
+    {
+      pos = start;
+      return fail("Expected a number");
+    }
+
+    if (*pos == '0')
+      pos++;
+    else
+      while (pos < end && isDigit(*pos))
+        pos++;
+
+    const char* digitsEnd = pos;
+    bool integral = true;
+
+    if (pos < end && *pos == '.')
+    {
+      integral = false;
+      pos++;
+      if (pos >= end || !isDigit(*pos))
+        return fail("Expected a digit");
+      while (pos < end && isDigit(*pos))
+        pos++;
+    }
+
+    if (pos < end && (*pos == 'e' || *pos == 'E'))
+    {
+      integral = false;
+      pos++;
+      if (pos < end && (*pos == '+' || *pos == '-'))
+        pos++;
+      if (pos >= end || !isDigit(*pos))
+        return fail("Expected a digit");
+      while (pos < end && isDigit(*pos))
+        pos++;
+    }
+
+    if (integral && digitsEnd - digits <= JSON_MAX_FAST_INTEGER_DIGITS)
+    {
+      int64_t integer = 0;
+      for (const char* digit = digits; digit < digitsEnd; digit++)
+        integer = integer * 10 + (*digit - '0');
+
+      value = (double) (negative ? -integer : integer);
+      return true;
+    }
+
+    // The text may not be null terminated, so strtod gets a copy of the number
+    char buffer[64];
+    size_t length = pos - start;
+    if (length < sizeof(buffer))
+    {
+      memcpy(buffer, start, length);
+      buffer[length] = '\0';
+      value = strtod(buffer, NULL);
+    }
+    else
+    {
+      value = strtod(string(start, length).c_str(), NULL);
+    }
+
+    return true;
+  }
+
+  bool JsonReader::readBoolean(bool& value)
+  {
+    if (hasError())
+      return false;
+
+    skipWhitespace();
+    if (pos < end && *pos == 't')
+    {
+      value = true;
+      return skipLiteral("true");
+    }
+    if (pos < end && *pos == 'f')
+    {
+      value = false;
+      return skipLiteral("false");
+    }
+
+    double number;
+    if (!readNumber(number))
+      return false;
+
+    value = number != 0;
+    return true;
+  }
+
+  bool JsonReader::readCodepoint(unsigned int& codepoint)
+  {
+    if (end - pos < 4 || !readHex4(pos, codepoint))
+      return fail("Invalid unicode escape");
+    pos += 4;
+
+    if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+      return fail("Unpaired surrogate in unicode escape");
+
+    // Characters outside the basic multilingual plane are escaped as a surrogate pair
+    if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+    {
+      unsigned int low;
+      if (end - pos < 6 || pos[0] != '\\' || pos[1] != 'u' || !readHex4(pos + 2, low) || low < 0xDC00 || low > 0xDFFF)
+        return fail("Unpaired surrogate in unicode escape");
+      pos += 6;
+
+      codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    return true;
+  }
+
+  bool JsonReader::readString(string& value)
+  {
+    if (!expect('"', "a string"))
+      return false;
+
+    value.clear();
+    while (true)
+    {
+      const char* run = pos;
+      while (pos < end && *pos != '"' && *pos != '\\' && (unsigned char) *pos >= 0x20)
+        pos++;
+      value.append(run, pos - run);
+
+      if (pos >= end)
+        return fail("Unterminated string");
+
+      if (*pos == '"')
+      {
+        pos++;
+        return true;
+      }
+
+      if (*pos != '\\')
+        return fail("Control character in string");
+
+      pos++;
+      if (pos >= end)
+        return fail("Unterminated string");
+
+      char escaped = *pos++;
+      switch (escaped)
+      {
+        case '"':
+        case '\\':
+        case '/':
+          value.push_back(escaped);
+          break;
+        case 'b':
+          value.push_back('\b');
+          break;
+        case 'f':
+          value.push_back('\f');
+          break;
+        case 'n':
+          value.push_back('\n');
+          break;
+        case 'r':
+          value.push_back('\r');
+          break;
+        case 't':
+          value.push_back('\t');
+          break;
+        case 'u':
+        {
+          unsigned int codepoint;
+          if (!readCodepoint(codepoint))
+            return false;
+          appendUtf8(value, codepoint);
+          break;
+        }
+        default:
+          pos--;
+          return fail("Invalid escape in string");
+      }
+    }
+  }
+
+  bool JsonReader::skipLiteral(const char* literal)
+  {
+    size_t length = strlen(literal);
+    if ((size_t) (end - pos) < length || memcmp(pos, literal, length) != 0)
+      return fail("Expected a value");
+
+    pos += length;
+    return true;
+  }
+
+  bool JsonReader::skipValue()
+  {
+    if (hasError())
+      return false;
+
+    skipWhitespace();
+    if (pos >= end)
+      return fail("Expected a value");
+
+    string text;
+    double number;
+    switch (*pos)
+    {
+      case '{':
+        if (!beginObject())
+          return false;
+        while (nextKey(text))
+          skipValue();
+        return !hasError();
+      case '[':
+        if (!beginArray())
+          return false;
+        while (nextElement())
+          skipValue();
+        return !hasError();
+      case '"':
+        return readString(text);
+      case 't':
+        return skipLiteral("true");
+      case 'f':
+        return skipLiteral("false");
+      case 'n':
+        return skipLiteral("null");
+      default:
+        return readNumber(number);
+    }
+  }
+
+  bool JsonReader::finish()
+  {
+    if (hasError())
+      return false;
+
+    if (firstValue.size() > 0)
+      return fail("Unterminated object or array");
+
+    skipWhitespace();
+    if (pos != end)
+      return fail("Unexpected data after the document");
+
+    return true;
+  }
+
+}
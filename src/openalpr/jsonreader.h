@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_JSONREADER_H
+#define OPENALPR_JSONREADER_H
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+namespace alpr
+{
+
+  // Pull parser that reads JSON one token at a time, without building a tree.  The caller walks the
+  // document in the order it expects it, and skips what it doesn't need.  The first syntax or type error
+  // is kept, after which every call returns false.
+  class JsonReader
+  {
+    public:
+      // The text must stay valid while it is read
+      JsonReader(const char* json, size_t length);
+
+      bool beginObject();
+      // Reads the name of the next member of the current object.  False at the end of the object, which
+      // is consumed, or on an error.
+      bool nextKey(std::string& name);
+
+      bool beginArray();
+      // True when another element follows in the current array.  False at the end of the array, which is
+      // consumed, or on an error.
+      bool nextElement();
+
+      bool readNumber(double& value);
+      // Accepts true/false, or a number which is true when non-zero
+      bool readBoolean(bool& value);
+      bool readString(std::string& value);
+      bool skipValue();
+
+      // Checks that nothing but whitespace follows the document
+      bool finish();
+
+      bool hasError() const;
+      std::string getError() const;
+
+      // Records an error found by the caller, e.g. a missing member
+      bool fail(std::string message);
+
+    private:
+      const char* json;
+      const char* pos;
+      const char* end;
+
+      // Whether the next member or element of each open object or array is its first one
+      std::vector<bool> firstValue;
+
+      std::string error;
+
+      void skipWhitespace();
+      bool expect(char c, const char* what);
+      bool beginNext(char close);
+      bool readCodepoint(unsigned int& codepoint);
+      bool skipLiteral(const char* literal);
+  };
+
+}
+
+#endif // OPENALPR_JSONREADER_H
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jsonwriter.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+
+using namespace std;
+
+namespace alpr
+{
+
+  JsonWriter::JsonWriter(string& output) : output(output)
+  {
+    this->afterKey = false;
+  }
+
+  void JsonWriter::beginValue()
+  {
+    if (afterKey)
+    {
+      afterKey = false;
+      return;
+    }
+
+    if (firstValue.size() > 0)
+    {
+      if (firstValue.back())
+        firstValue.back() = false;
+      else
+        output.push_back(',');
+    }
+  }
+
+  void JsonWriter::beginObject()
+  {
+    beginValue();
+    output.push_back('{');
+    firstValue.push_back(true);
+  }
+
+  void JsonWriter::endObject()
+  {
+    output.push_back('}');
+    firstValue.pop_back();
+  }
+
+  void JsonWriter::beginArray()
+  {
+    beginValue();
+    output.push_back('[');
+    firstValue.push_back(true);
+  }
+
+  void JsonWriter::endArray()
+  {
+    output.push_back(']');
+    firstValue.pop_back();
+  }
+
+  void JsonWriter::key(const char* name)
+  {
+    beginValue();
+    appendQuoted(name);
+    output.push_back(':');
+    afterKey = true;
+  }
+
+  void JsonWriter::writeNumber(double value)
+  {
+    beginValue();
+
+    // Same tests as print_number in cjson.c
+    if (value <= INT_MAX && value >= INT_MIN && fabs(((double) ((int) value)) - value) <= DBL_EPSILON)
+    {
+      appendInteger((int) value);
+      return;
+    }
+
+    bool whole = fabs(floor(value) - value) <= DBL_EPSILON && fabs(value) < 1.0e60;
+
+    // Past the int range, whole numbers print as plain digits with %.0f
+    if (whole && fabs(value) < 9.0e18)
+    {
+      appendInteger((int64_t) value);
+      return;
+    }
+
+    char buffer[64];
+    if (whole)
+      sprintf(buffer, "%.0f", value);
+    else if (fabs(value) < 1.0e-6 || fabs(value) > 1.0e9)
+      sprintf(buffer, "%e", value);
+    else
+      sprintf(buffer, "%f", value);
+
+    output.append(buffer);
+  }
+
+  void JsonWriter::writeString(const char* value)
+  {
+    beginValue();
+    appendQuoted(value);
+  }
+
+  void JsonWriter::writeString(const string& value)
+  {
+    writeString(value.c_str());
+  }
+
+  void JsonWriter::addNumber(const char* name, double value)
+  {
+    key(name);
+    writeNumber(value);
+  }
+
+  void JsonWriter::addString(const char* name, const char* value)
+  {
+    key(name);
+    writeString(value);
+  }
+
+  void JsonWriter::addString(const char* name, const string& value)
+  {
+    key(name);
+    writeString(value.c_str());
+  }
+
+  void JsonWriter::beginObject(const char* name)
+  {
+    key(name);
+    beginObject();
+  }
+
+  void JsonWriter::beginArray(const char* name)
+  {
+    key(name);
+    beginArray();
+  }
+
+  void JsonWriter::appendInteger(int64_t value)
+  {
+    char digits[24];
+    int length = 0;
+
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t) value : (uint64_t) value;
+    do
+    {
+      digits[length++] = (char) ('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0)
+      output.push_back('-');
+
+    while (length > 0)
+      output.push_back(digits[--length]);
+  }
+
+  // Same escaping as print_string_ptr in cjson.c
+  void JsonWriter::appendQuoted(const char* value)
+  {
+    output.push_back('\"');
+
+    for (const char* ptr = value; *ptr; ptr++)
+    {
+      unsigned char token = (unsigned char) *ptr;
+      if (token > 31 && token != '\"' && token != '\\')
+      {
+        output.push_back(*ptr);
+        continue;
+      }
+
+      output.push_back('\\');
+      switch (token)
+      {
+        case '\\':	output.push_back('\\');	break;
+        case '\"':	output.push_back('\"');	break;
+        case '\b':	output.push_back('b');	break;
+        case '\f':	output.push_back('f');	break;
+        case '\n':	output.push_back('n');	break;
+        case '\r':	output.push_back('r');	break;
+        case '\t':	output.push_back('t');	break;
+        default:
+        {
+          char escaped[8];
+          sprintf(escaped, "u%04x", token);
+          output.append(escaped);
+          break;
+        }
+      }
+    }
+
+    output.push_back('\"');
+  }
+
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_JSONWRITER_H
+#define OPENALPR_JSONWRITER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace alpr
+{
+
+  // Writes JSON straight into a string, byte for byte the way cJSON_PrintUnformatted prints the
+  // equivalent cJSON tree, without building the tree.  The string is appended to, so a buffer
+  // can be cleared and reused.
+  class JsonWriter
+  {
+    public:
+      JsonWriter(std::string& output);
+
+      void beginObject();
+      void endObject();
+      void beginArray();
+      void endArray();
+
+      // Starts a member of the current object.  The next value written is its value.
+      void key(const char* name);
+
+      // Numbers follow cJSON: integral values are printed as integers, others with printf
+      void writeNumber(double value);
+      void writeString(const char* value);
+      void writeString(const std::string& value);
+
+      // Shorthands for a member of the current object
+      void addNumber(const char* name, double value);
+      void addString(const char* name, const char* value);
+      void addString(const char* name, const std::string& value);
+      void beginObject(const char* name);
+      void beginArray(const char* name);
+
+    private:
+      std::string& output;
+
+      // Whether the next value in each open object or array is its first one
+      std::vector<bool> firstValue;
+      bool afterKey;
+
+      void beginValue();
+      void appendInteger(int64_t value);
+      void appendQuoted(const char* value);
+  };
+
+}
+
+#endif // OPENALPR_JSONWRITER_H
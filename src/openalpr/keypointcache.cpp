@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "keypointcache.h"
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include "support/filesystem.h"
+
+using namespace cv;
+using namespace std;
+
+namespace alpr
+{
+
+  static const char KEYPOINT_CACHE_MAGIC[8] = {'O', 'A', 'L', 'P', 'R', 'K', 'P', 'C'};
+  static const int KEYPOINT_CACHE_VERSION = 1;
+
+  // Sanity limits, so a corrupt file fails to load rather than allocating huge buffers
+  static const int MAX_STRING_LENGTH = 1 << 20;
+  static const int MAX_ELEMENTS = 1 << 24;
+
+  template <typename T>
+  static void writeValue(ofstream& out, T value)
+  {
+    out.write((const char*) &value, sizeof(T));
+  }
+
+  template <typename T>
+  static bool readValue(ifstream& in, T& value)
+  {
+    in.read((char*) &value, sizeof(T));
+    return in.good();
+  }
+
+  static void writeString(ofstream& out, const string& value)
+  {
+    writeValue<int>(out, value.size());
+    out.write(value.data(), value.size());
+  }
+
+  static bool readString(ifstream& in, string& value)
+  {
+    int length;
+    if (readValue(in, length) == false || length < 0 || length > MAX_STRING_LENGTH)
+      return false;
+
+    value.resize(length);
+    if (length > 0)
+      in.read(&value[0], length);
+
+    return in.good();
+  }
+
+  bool readKeypointCache(string filename, string signature, vector<KeypointCacheEntry>& entries)
+  {
+    ifstream in(filename.c_str(), ios::in | ios::binary);
+    if (in.is_open() == false)
+      return false;
+
+    char magic[8];
+    in.read(magic, sizeof(magic));
+    if (in.good() == false || memcmp(magic, KEYPOINT_CACHE_MAGIC, sizeof(magic)) != 0)
+      return false;
+
+    int version;
+    string fileSignature;
+    if (readValue(in, version) == false || version != KEYPOINT_CACHE_VERSION)
+      return false;
+    if (readString(in, fileSignature) == false || fileSignature != signature)
+      return false;
+
+    int entryCount;
+    if (readValue(in, entryCount) == false || entryCount < 0 || entryCount > MAX_ELEMENTS)
+      return false;
+
+    vector<KeypointCacheEntry> loaded(entryCount);
+    for (int i = 0; i < entryCount; i++)
+    {
+      KeypointCacheEntry& entry = loaded[i];
+
+      int keypointCount;
+      if (readString(in, entry.name) == false || readValue(in, keypointCount) == false ||
+          keypointCount < 0 || keypointCount > MAX_ELEMENTS)
+        return false;
+
+      entry.keypoints.resize(keypointCount);
+      for (int k = 0; k < keypointCount; k++)
+      {
+        KeyPoint& kp = entry.keypoints[k];
+        readValue(in, kp.pt.x);
+        readValue(in, kp.pt.y);
+        readValue(in, kp.size);
+        readValue(in, kp.angle);
+        readValue(in, kp.response);
+        readValue(in, kp.octave);
+        if (readValue(in, kp.class_id) == false)
+          return false;
+      }
+
+      int rows, cols, type;
+      readValue(in, rows);
+      readValue(in, cols);
+      // BRISK descriptors are always 8 bit, single channel
+      if (readValue(in, type) == false || type != CV_8U || rows < 0 || cols < 0 || (double) rows * cols > MAX_ELEMENTS)
+        return false;
+
+      entry.descriptors.create(rows, cols, type);
+      for (int r = 0; r < rows; r++)
+        in.read((char*) entry.descriptors.ptr(r), cols * entry.descriptors.elemSize());
+
+      if (in.good() == false)
+        return false;
+    }
+
+    entries.swap(loaded);
+    return true;
+  }
+
+  bool writeKeypointCache(string filename, string signature, const vector<KeypointCacheEntry>& entries)
+  {
+    // Written under a name of its own and then renamed over the cache, so that other threads and
+    // processes loading the cache never see it truncated or half written
+    stringstream tempFilename;
+    tempFilename << filename << ".tmp" << getpid();
+
+    ofstream out(tempFilename.str().c_str(), ios::out | ios::binary | ios::trunc);
+    if (out.is_open() == false)
+      return false;
+
+    out.write(KEYPOINT_CACHE_MAGIC, sizeof(KEYPOINT_CACHE_MAGIC));
+    writeValue<int>(out, KEYPOINT_CACHE_VERSION);
+    writeString(out, signature);
+
+    writeValue<int>(out, entries.size());
+    for (unsigned int i = 0; i < entries.size(); i++)
+    {
+      const KeypointCacheEntry& entry = entries[i];
+
+      writeString(out, entry.name);
+      writeValue<int>(out, entry.keypoints.size());
+      for (unsigned int k = 0; k < entry.keypoints.size(); k++)
+      {
+        const KeyPoint& kp = entry.keypoints[k];
+        writeValue(out, kp.pt.x);
+        writeValue(out, kp.pt.y);
+        writeValue(out, kp.size);
+        writeValue(out, kp.angle);
+        writeValue(out, kp.response);
+        writeValue(out, kp.octave);
+        writeValue(out, kp.class_id);
+      }
+
+      writeValue<int>(out, entry.descriptors.rows);
+      writeValue<int>(out, entry.descriptors.cols);
+      writeValue<int>(out, entry.descriptors.type());
+      for (int r = 0; r < entry.descriptors.rows; r++)
+        out.write((const char*) entry.descriptors.ptr(r), entry.descriptors.cols * entry.descriptors.elemSize());
+    }
+
+    out.close();
+    if (out.good() == false)
+    {
+      remove(tempFilename.str().c_str());
+      return false;
+    }
+
+    // Windows doesn't rename over an existing file
+    if (rename(tempFilename.str().c_str(), filename.c_str()) != 0 &&
+        (remove(filename.c_str()) != 0 || rename(tempFilename.str().c_str(), filename.c_str()) != 0))
+    {
+      remove(tempFilename.str().c_str());
+      return false;
+    }
+
+    return true;
+  }
+
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_KEYPOINTCACHE_H
+#define OPENALPR_KEYPOINTCACHE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/features2d/features2d.hpp"
+
+namespace alpr
+{
+
+  // The keypoints and descriptors extracted from one training plate image
+  struct KeypointCacheEntry
+  {
+    std::string name;
+    std::vector<cv::KeyPoint> keypoints;
+    cv::Mat descriptors;
+  };
+
+  // Binary file holding the keypoints and descriptors of a country's training plates, so they don't
+  // have to be extracted from the images every time the state identifier starts.  The signature
+  // describes the extractor parameters and the source images.  A file written with a different
+  // signature is stale and is not read.
+  bool readKeypointCache(std::string filename, std::string signature, std::vector<KeypointCacheEntry>& entries);
+  bool writeKeypointCache(std::string filename, std::string signature, const std::vector<KeypointCacheEntry>& entries);
+
+}
+
+#endif // OPENALPR_KEYPOINTCACHE_H
@@ -51,8 +51,11 @@ namespace alpr
 
     Rect expandedRegion = this->pipeline_data->regionOfInterest;
 
-    pipeline_data->crop_gray = Mat(this->pipeline_data->grayImg, expandedRegion);
-    resize(pipeline_data->crop_gray, pipeline_data->crop_gray, Size(config->templateWidthPx, config->templateHeightPx));
+    // The crops are written into scratch buffers, which a reused PipelineData keeps between plates
+    Size templateSize(config->templateWidthPx, config->templateHeightPx);
+    Mat& templateCrop = pipeline_data->scratch.get(PipelineData::SCRATCH_TEMPLATE_CROP, templateSize, pipeline_data->grayImg.type());
+    resize(Mat(this->pipeline_data->grayImg, expandedRegion), templateCrop, templateSize);
+    pipeline_data->crop_gray = templateCrop;
 
 
     CharacterAnalysis textAnalysis(pipeline_data);
@@ -78,7 +81,9 @@ namespace alpr
     Size cropSize = imgTransform.getCropSize(pipeline_data->plate_corners, 
             Size(pipeline_data->config->ocrImageWidthPx, pipeline_data->config->ocrImageHeightPx));
     Mat transmtx = imgTransform.getTransformationMatrix(pipeline_data->plate_corners, cropSize);
-    pipeline_data->crop_gray = imgTransform.crop(cropSize, transmtx);
+    Mat& deskewedCrop = pipeline_data->scratch.get(PipelineData::SCRATCH_DESKEWED_CROP, cropSize, pipeline_data->grayImg.type());
+    imgTransform.crop(cropSize, transmtx, deskewedCrop);
+    pipeline_data->crop_gray = deskewedCrop;
 
 
     if (this->config->debugGeneral)
@@ -103,9 +108,7 @@ namespace alpr
       newLines.push_back(TextLine(textAreaRemapped, linePolygonRemapped, pipeline_data->crop_gray.size()));
     }
 
-    pipeline_data->textLines.clear();
-    for (unsigned int i = 0; i < newLines.size(); i++)
-      pipeline_data->textLines.push_back(newLines[i]);
+    pipeline_data->textLines.swap(newLines);
 
 
 
@@ -21,113 +21,97 @@
 
 using namespace std;
 using namespace cv;
-using namespace tesseract;
 
 namespace alpr
 {
 
   OCR::OCR(Config* config)
-  : postProcessor(config)
+  : postProcessor(config), glyphCache(config->ocrGlyphCacheSize)
   {
-    const string EXPECTED_TESSERACT_VERSION = "3.03";
-
     this->config = config;
-
-
-    if (startsWith(tesseract.Version(), EXPECTED_TESSERACT_VERSION) == false)
-    {
-      std::cerr << "Warning: You are running an unsupported version of Tesseract." << endl;
-      std::cerr << "Expecting version " << EXPECTED_TESSERACT_VERSION << ", your version is: " << tesseract.Version() << endl;
-    }
-
-    // Tesseract requires the prefix directory to be set as an env variable
-    tesseract.Init(config->getTessdataPrefix().c_str(), config->ocrLanguage.c_str() 	);
-    tesseract.SetVariable("save_blob_choices", "T");
-    tesseract.SetPageSegMode(PSM_SINGLE_CHAR);
+    this->whitelistRegion = "";
   }
 
   OCR::~OCR()
   {
-    tesseract.Clear();
   }
 
   void OCR::performOCR(PipelineData* pipeline_data)
   {
-    const int SPACE_CHAR_CODE = 32;
-    
     timespec startTime;
     getTimeMonotonic(&startTime);
 
     postProcessor.clear();
+    pipeline_data->ocrThresholdsUsed = 0;
 
     // Don't waste time on OCR processing if it is impossible to get sufficient characters
     if (pipeline_data->charRegions.size() < config->postProcessMinCharacters)
       return;
 
+    // Highest confidence seen for each letter at each char position
+    vector<map<string, float> > letterConfidences(pipeline_data->charRegions.size());
+
+    // Whether each letter seen at each char position fits the whitelist region
+    vector<map<string, bool> > whitelist(pipeline_data->charRegions.size());
+
     for (unsigned int i = 0; i < pipeline_data->thresholds.size(); i++)
     {
       // Make it black text on white background
       bitwise_not(pipeline_data->thresholds[i], pipeline_data->thresholds[i]);
-      tesseract.SetImage((uchar*) pipeline_data->thresholds[i].data, 
-                          pipeline_data->thresholds[i].size().width, pipeline_data->thresholds[i].size().height, 
-                          pipeline_data->thresholds[i].channels(), pipeline_data->thresholds[i].step1());
 
-      for (unsigned int j = 0; j < pipeline_data->charRegions.size(); j++)
+      const Mat& threshold = pipeline_data->thresholds[i];
+      unsigned int charCount = pipeline_data->charRegions.size();
+
+      vector<vector<OcrChoice> > charChoices(charCount);
+      vector<bool> charsToRecognize(charCount, true);
+
+      vector<GlyphKey> glyphKeys;
+      if (glyphCache.getCapacity() > 0)
       {
-        Rect expandedRegion = expandRect( pipeline_data->charRegions[j], 2, 2, pipeline_data->thresholds[i].cols, pipeline_data->thresholds[i].rows) ;
+        glyphKeys.resize(charCount);
+        for (unsigned int j = 0; j < charCount; j++)
+        {
+          // The same area the Tesseract backend recognizes
+          Rect glyphRegion = expandRect(pipeline_data->charRegions[j], 2, 2, threshold.cols, threshold.rows);
+          glyphCache.makeKey(threshold(glyphRegion), glyphKeys[j]);
+
+          if (glyphCache.lookup(glyphKeys[j], charChoices[j]))
+            charsToRecognize[j] = false;
+        }
+      }
+
+      recognizeCharacters(threshold, pipeline_data->charRegions, i, charsToRecognize, charChoices);
 
-        tesseract.SetRectangle(expandedRegion.x, expandedRegion.y, expandedRegion.width, expandedRegion.height);
-        tesseract.Recognize(NULL);
+      for (unsigned int j = 0; j < glyphKeys.size(); j++)
+      {
+        if (charsToRecognize[j])
+          glyphCache.insert(glyphKeys[j], charChoices[j]);
+      }
 
-        tesseract::ResultIterator* ri = tesseract.GetIterator();
-        tesseract::PageIteratorLevel level = tesseract::RIL_SYMBOL;
-        do
+      for (unsigned int j = 0; j < charChoices.size(); j++)
+      {
+        for (unsigned int c = 0; c < charChoices[j].size(); c++)
         {
-          const char* symbol = ri->GetUTF8Text(level);
-          float conf = ri->Confidence(level);
-          
-          bool dontcare;
-          int fontindex = 0;
-          int pointsize = 0;
-          const char* fontName = ri->WordFontAttributes(&dontcare, &dontcare, &dontcare, &dontcare, &dontcare, &dontcare, &pointsize, &fontindex);
-
-          // Ignore NULL pointers, spaces, and characters that are way too small to be valid
-          if(symbol != 0 && symbol[0] != SPACE_CHAR_CODE && pointsize >= config->ocrMinFontSize)
-          {
-            postProcessor.addLetter(string(symbol), j, conf);
-
-            if (this->config->debugOcr)
-              printf("charpos%d: threshold %d:  symbol %s, conf: %f font: %s (index %d) size %dpx", j, i, symbol, conf, fontName, fontindex, pointsize);
-
-            bool indent = false;
-            tesseract::ChoiceIterator ci(*ri);
-            do
-            {
-              const char* choice = ci.GetUTF8Text();
-
-              postProcessor.addLetter(string(choice), j, ci.Confidence());
-
-              //letterScores.addScore(*choice, j, ci.Confidence() - MIN_CONFIDENCE);
-              if (this->config->debugOcr)
-              {
-                if (indent) printf("\t\t ");
-                printf("\t- ");
-                printf("%s conf: %f\n", choice, ci.Confidence());
-              }
-
-              indent = true;
-            }
-            while(ci.Next());
-          }
-
-          if (this->config->debugOcr)
-            printf("---------------------------------------------\n");
-
-          delete[] symbol;
+          // A pruned letter still counts towards the skip positions
+          bool allowed = isWhitelisted(whitelist, charChoices[j][c].letter, j);
+          postProcessor.addLetter(charChoices[j][c].letter, j, charChoices[j][c].confidence, allowed);
+          if (allowed == false)
+            continue;
+
+          float& bestConfidence = letterConfidences[j][charChoices[j][c].letter];
+          bestConfidence = max(bestConfidence, charChoices[j][c].confidence);
         }
-        while((ri->Next(level)));
+      }
+
+      pipeline_data->ocrThresholdsUsed = i + 1;
 
-        delete ri;
+      if (config->ocrEarlyExitConfidence > 0 && i + 1 < pipeline_data->thresholds.size() && allCharactersConfident(letterConfidences))
+      {
+        // Leave the remaining thresholds black on white like the ones that were read
+        for (unsigned int t = i + 1; t < pipeline_data->thresholds.size(); t++)
+          bitwise_not(pipeline_data->thresholds[t], pipeline_data->thresholds[t]);
+
+        break;
       }
     }
 
@@ -135,8 +119,72 @@ namespace alpr
     {
       timespec endTime;
       getTimeMonotonic(&endTime);
-      cout << "OCR Time: " << diffclock(startTime, endTime) << "ms." << endl;
+      cout << "OCR Time: " << diffclock(startTime, endTime) << "ms. (" << pipeline_data->ocrThresholdsUsed << " of " << pipeline_data->thresholds.size() << " thresholds)" << endl;
+
+      if (glyphCache.getCapacity() > 0)
+        cout << "OCR glyph cache: " << glyphCache.getHits() << " hits, " << glyphCache.getMisses() << " misses" << endl;
+    }
+  }
+
+  // True when the best letter at every char position is above the early exit confidence, and ahead of
+  // the runner up by the early exit margin.  More thresholds would not change the result.
+  bool OCR::allCharactersConfident(const vector<map<string, float> >& letterConfidences)
+  {
+    for (unsigned int j = 0; j < letterConfidences.size(); j++)
+    {
+      float best = 0;
+      float runnerUp = 0;
+      for (map<string, float>::const_iterator it = letterConfidences[j].begin(); it != letterConfidences[j].end(); ++it)
+      {
+        if (it->second > best)
+        {
+          runnerUp = best;
+          best = it->second;
+        }
+        else if (it->second > runnerUp)
+        {
+          runnerUp = it->second;
+        }
+      }
+
+      if (best < config->ocrEarlyExitConfidence || best - runnerUp < config->ocrEarlyExitMargin)
+        return false;
     }
+
+    return true;
+  }
+
+  void OCR::setWhitelistRegion(string region)
+  {
+    this->whitelistRegion = region;
+  }
+
+  bool OCR::isWhitelisted(vector<map<string, bool> >& whitelist, string letter, int charposition)
+  {
+    if (whitelistRegion.size() == 0)
+      return true;
+
+    map<string, bool>::iterator known = whitelist[charposition].find(letter);
+    if (known != whitelist[charposition].end())
+      return known->second;
+
+    bool allowed = postProcessor.letterFitsRegion(whitelistRegion, letter, charposition, whitelist.size());
+    whitelist[charposition][letter] = allowed;
+
+    if (allowed == false && config->debugOcr)
+      cout << "charpos" << charposition << ": " << letter << " does not fit the patterns for " << whitelistRegion << endl;
+
+    return allowed;
+  }
+
+  int OCR::getGlyphCacheHits()
+  {
+    return glyphCache.getHits();
+  }
+
+  int OCR::getGlyphCacheMisses()
+  {
+    return glyphCache.getMisses();
   }
 
-}
\ No newline at end of file
+}
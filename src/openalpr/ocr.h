@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <stdio.h>
+#include <map>
 
 #include "utility.h"
 #include "postprocess/postprocess.h"
@@ -31,12 +32,13 @@
 #include "constants.h"
 #include "opencv2/imgproc/imgproc.hpp"
 #include "support/filesystem.h"
-
-#include "tesseract/baseapi.h"
+#include "ocr/glyphcache.h"
 
 namespace alpr
 {
 
+  // Base class for the OCR backends.  Runs every threshold of a plate through the backend
+  // and collects the letters in the post processor.
   class OCR
   {
 
@@ -48,10 +50,28 @@ namespace alpr
 
       PostProcess postProcessor;
 
-    private:
+      int getGlyphCacheHits();
+      int getGlyphCacheMisses();
+
+      // Only letters that fit the region's patterns become candidates in the post processor.  Empty to allow all letters.
+      void setWhitelistRegion(std::string region);
+
+    protected:
       Config* config;
 
-      tesseract::TessBaseAPI tesseract;
+      // Letters previously recognized for identical glyphs, kept across plates and frames
+      GlyphCache glyphCache;
+
+      bool allCharactersConfident(const std::vector<std::map<std::string, float> >& letterConfidences);
+
+      std::string whitelistRegion;
+      bool isWhitelisted(std::vector<std::map<std::string, bool> >& whitelist, std::string letter, int charposition);
+
+      // Recognizes the character regions of a threshold image (black text on a white background) that
+      // are flagged in charsToRecognize.  charChoices has one entry per character region, which is filled
+      // in with the letters to add to the post processor for that position, in order.
+      virtual void recognizeCharacters(const cv::Mat& threshold, const std::vector<cv::Rect>& charRegions, int thresholdIndex,
+                                       const std::vector<bool>& charsToRecognize, std::vector<std::vector<OcrChoice> >& charChoices) = 0;
 
   };
 
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "glyphcache.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace cv;
+
+namespace alpr
+{
+
+  static bool sameGlyph(const GlyphKey& left, const GlyphKey& right)
+  {
+    return left.width == right.width && left.height == right.height && left.bits == right.bits;
+  }
+
+  GlyphCache::GlyphCache(int capacity)
+  {
+    this->capacity = capacity;
+    this->hits = 0;
+    this->misses = 0;
+  }
+
+  GlyphCache::~GlyphCache()
+  {
+  }
+
+  int GlyphCache::getCapacity()
+  {
+    return capacity;
+  }
+
+  void GlyphCache::makeKey(const Mat& glyph, GlyphKey& key)
+  {
+    const uchar INK_THRESHOLD = 128;
+
+    // Ink bounding box, so the key doesn't depend on where the character sits in its box
+    int minX = glyph.cols;
+    int maxX = -1;
+    int minY = glyph.rows;
+    int maxY = -1;
+    for (int y = 0; y < glyph.rows; y++)
+    {
+      const uchar* row = glyph.ptr<uchar>(y);
+      for (int x = 0; x < glyph.cols; x++)
+      {
+        if (row[x] < INK_THRESHOLD)
+        {
+          minX = min(minX, x);
+          maxX = max(maxX, x);
+          minY = min(minY, y);
+          maxY = max(maxY, y);
+        }
+      }
+    }
+
+    key.width = max(0, maxX - minX + 1);
+    key.height = max(0, maxY - minY + 1);
+    key.bits.assign((key.width * key.height + 7) / 8, 0);
+
+    int bit = 0;
+    for (int y = 0; y < key.height; y++)
+    {
+      const uchar* row = glyph.ptr<uchar>(minY + y) + minX;
+      for (int x = 0; x < key.width; x++)
+      {
+        if (row[x] < INK_THRESHOLD)
+          key.bits[bit / 8] |= (1 << (bit % 8));
+        bit++;
+      }
+    }
+
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    hash = (hash ^ key.width) * 16777619u;
+    hash = (hash ^ key.height) * 16777619u;
+    for (unsigned int i = 0; i < key.bits.size(); i++)
+      hash = (hash ^ key.bits[i]) * 16777619u;
+    key.hash = hash;
+  }
+
+  bool GlyphCache::lookup(const GlyphKey& key, vector<OcrChoice>& choices)
+  {
+    map<unsigned int, list<Entry>::iterator>::iterator found = entriesByHash.find(key.hash);
+    if (found == entriesByHash.end() || sameGlyph(found->second->key, key) == false)
+    {
+      misses++;
+      return false;
+    }
+
+    entries.splice(entries.begin(), entries, found->second);
+    choices = found->second->choices;
+    hits++;
+
+    return true;
+  }
+
+  void GlyphCache::insert(const GlyphKey& key, const vector<OcrChoice>& choices)
+  {
+    if (capacity <= 0)
+      return;
+
+    map<unsigned int, list<Entry>::iterator>::iterator found = entriesByHash.find(key.hash);
+    if (found != entriesByHash.end())
+    {
+      // Same hash, possibly a different glyph.  Only one entry is kept per hash.
+      found->second->key = key;
+      found->second->choices = choices;
+      entries.splice(entries.begin(), entries, found->second);
+      return;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.choices = choices;
+    entries.push_front(entry);
+    entriesByHash[key.hash] = entries.begin();
+
+    if ((int) entriesByHash.size() > capacity)
+    {
+      entriesByHash.erase(entries.back().key.hash);
+      entries.pop_back();
+    }
+  }
+
+  void GlyphCache::clear()
+  {
+    entries.clear();
+    entriesByHash.clear();
+  }
+
+  int GlyphCache::getHits()
+  {
+    return hits;
+  }
+
+  int GlyphCache::getMisses()
+  {
+    return misses;
+  }
+
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_GLYPHCACHE_H
+#define OPENALPR_GLYPHCACHE_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "opencv2/core/core.hpp"
+
+namespace alpr
+{
+
+  struct OcrChoice
+  {
+    std::string letter;
+    float confidence;
+  };
+
+  // A binarized glyph, cropped to its ink and packed 8 pixels to a byte
+  struct GlyphKey
+  {
+    unsigned int hash;
+    int width;
+    int height;
+    std::vector<unsigned char> bits;
+  };
+
+  // Bounded least recently used cache of the OCR letters for each glyph.  Identical glyphs are common:
+  // the thresholds of a clean plate often agree, and a parked car shows the same plate frame after frame.
+  class GlyphCache
+  {
+
+    public:
+      GlyphCache(int capacity);
+      virtual ~GlyphCache();
+
+      int getCapacity();
+
+      // Glyphs are black text on a white background
+      void makeKey(const cv::Mat& glyph, GlyphKey& key);
+
+      bool lookup(const GlyphKey& key, std::vector<OcrChoice>& choices);
+      void insert(const GlyphKey& key, const std::vector<OcrChoice>& choices);
+
+      void clear();
+
+      int getHits();
+      int getMisses();
+
+    private:
+      struct Entry
+      {
+        GlyphKey key;
+        std::vector<OcrChoice> choices;
+      };
+
+      int capacity;
+      int hits;
+      int misses;
+
+      // Most recently used first
+      std::list<Entry> entries;
+      std::map<unsigned int, std::list<Entry>::iterator> entriesByHash;
+  };
+
+}
+
+#endif // OPENALPR_GLYPHCACHE_H
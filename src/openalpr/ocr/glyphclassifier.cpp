@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "glyphclassifier.h"
+
+#include <algorithm>
+#include <map>
+
+#include "opencv2/imgproc/imgproc.hpp"
+
+using namespace std;
+using namespace cv;
+
+namespace alpr
+{
+
+  // Bumped whenever the features change, so that stale models are rejected
+  static const int GLYPH_MODEL_VERSION = 1;
+
+  // The aspect ratio is weighted so that a thin "1" doesn't match a full width "I" stretched to the grid
+  static const float ASPECT_RATIO_WEIGHT = 0.5;
+
+  static bool choiceCompare(const OcrChoice& left, const OcrChoice& right)
+  {
+    return left.confidence > right.confidence;
+  }
+
+  GlyphClassifier::GlyphClassifier()
+  {
+  }
+
+  GlyphClassifier::~GlyphClassifier()
+  {
+  }
+
+  void GlyphClassifier::addSample(string letter, const Mat& glyph)
+  {
+    Mat features;
+    if (getFeatures(glyph, features) == false)
+      return;
+
+    samples.push_back(features);
+    labels.push_back(letter);
+  }
+
+  vector<OcrChoice> GlyphClassifier::classify(const Mat& glyph, unsigned int maxChoices)
+  {
+    vector<OcrChoice> choices;
+
+    Mat features;
+    if (samples.rows == 0 || getFeatures(glyph, features) == false)
+      return choices;
+
+    // Closest sample of each letter
+    map<string, float> closestDistances;
+    const float* featureValues = features.ptr<float>(0);
+    for (int i = 0; i < samples.rows; i++)
+    {
+      const float* sampleValues = samples.ptr<float>(i);
+
+      float distance = 0;
+      for (int f = 0; f < FEATURE_COUNT; f++)
+      {
+        float diff = sampleValues[f] - featureValues[f];
+        distance += diff * diff;
+      }
+
+      map<string, float>::iterator existing = closestDistances.find(labels[i]);
+      if (existing == closestDistances.end())
+        closestDistances[labels[i]] = distance;
+      else if (distance < existing->second)
+        existing->second = distance;
+    }
+
+    // The grid features have unit length, so half the squared distance is one minus the cosine similarity
+    for (map<string, float>::iterator it = closestDistances.begin(); it != closestDistances.end(); ++it)
+    {
+      OcrChoice choice;
+      choice.letter = it->first;
+      choice.confidence = max(0.0f, 1.0f - (it->second / 2)) * 100;
+      choices.push_back(choice);
+    }
+
+    sort(choices.begin(), choices.end(), choiceCompare);
+    if (choices.size() > maxChoices)
+      choices.resize(maxChoices);
+
+    return choices;
+  }
+
+  bool GlyphClassifier::load(string filename)
+  {
+    FileStorage fs(filename, FileStorage::READ);
+    if (fs.isOpened() == false)
+      return false;
+
+    if ((int) fs["version"] != GLYPH_MODEL_VERSION || (int) fs["grid_width"] != GRID_WIDTH || (int) fs["grid_height"] != GRID_HEIGHT)
+    {
+      cerr << "Glyph classifier model " << filename << " is out of date.  It needs to be retrained." << endl;
+      return false;
+    }
+
+    Mat loadedSamples;
+    fs["samples"] >> loadedSamples;
+
+    vector<string> loadedLabels;
+    FileNode labelNodes = fs["labels"];
+    for (FileNodeIterator it = labelNodes.begin(); it != labelNodes.end(); ++it)
+      loadedLabels.push_back((string) *it);
+
+    if (loadedSamples.cols != FEATURE_COUNT || loadedSamples.type() != CV_32F || loadedSamples.rows != (int) loadedLabels.size())
+    {
+      cerr << "Glyph classifier model " << filename << " is invalid." << endl;
+      return false;
+    }
+
+    samples = loadedSamples;
+    labels = loadedLabels;
+
+    return true;
+  }
+
+  bool GlyphClassifier::save(string filename)
+  {
+    FileStorage fs(filename, FileStorage::WRITE);
+    if (fs.isOpened() == false)
+      return false;
+
+    fs << "version" << GLYPH_MODEL_VERSION;
+    fs << "grid_width" << GRID_WIDTH;
+    fs << "grid_height" << GRID_HEIGHT;
+
+    fs << "labels" << "[";
+    for (unsigned int i = 0; i < labels.size(); i++)
+      fs << labels[i];
+    fs << "]";
+
+    fs << "samples" << samples;
+
+    return true;
+  }
+
+  int GlyphClassifier::getSampleCount()
+  {
+    return samples.rows;
+  }
+
+  bool GlyphClassifier::getFeatures(const Mat& glyph, Mat& features)
+  {
+    Mat ink;
+    if (glyph.channels() > 1)
+      cvtColor(glyph, ink, CV_BGR2GRAY);
+    else
+      ink = glyph;
+
+    // White on black, so that the cell averages measure the ink coverage
+    Mat inverted;
+    bitwise_not(ink, inverted);
+
+    Mat inkPixels;
+    threshold(inverted, inkPixels, 127, 255, THRESH_BINARY);
+
+    vector<Point> points;
+    for (int y = 0; y < inkPixels.rows; y++)
+    {
+      const uchar* row = inkPixels.ptr<uchar>(y);
+      for (int x = 0; x < inkPixels.cols; x++)
+      {
+        if (row[x] != 0)
+          points.push_back(Point(x, y));
+      }
+    }
+
+    if (points.size() == 0)
+      return false;
+
+    Rect inkBox = boundingRect(points);
+
+    Mat grid;
+    resize(inverted(inkBox), grid, Size(GRID_WIDTH, GRID_HEIGHT), 0, 0, INTER_AREA);
+
+    features.create(1, FEATURE_COUNT, CV_32F);
+    float* values = features.ptr<float>(0);
+    for (int y = 0; y < GRID_HEIGHT; y++)
+    {
+      const uchar* row = grid.ptr<uchar>(y);
+      for (int x = 0; x < GRID_WIDTH; x++)
+        values[y * GRID_WIDTH + x] = row[x] / 255.0f;
+    }
+
+    Mat gridFeatures = features.colRange(0, GRID_WIDTH * GRID_HEIGHT);
+    double length = norm(gridFeatures);
+    if (length > 0)
+      gridFeatures /= length;
+
+    values[FEATURE_COUNT - 1] = ASPECT_RATIO_WEIGHT * ((float) inkBox.width) / ((float) inkBox.height);
+
+    return true;
+  }
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_GLYPHCLASSIFIER_H
+#define OPENALPR_GLYPHCLASSIFIER_H
+
+#include <string>
+#include <vector>
+
+#include "opencv2/core/core.hpp"
+
+#include "ocr.h"
+
+namespace alpr
+{
+
+  // Nearest neighbor classifier for single character images.  Each glyph is cropped to its ink,
+  // scaled to a small fixed grid, and described by the ink coverage of every grid cell plus its
+  // aspect ratio.  The samples are the character images saved by openalpr-utils-classifychars.
+  class GlyphClassifier
+  {
+
+    public:
+      GlyphClassifier();
+      virtual ~GlyphClassifier();
+
+      // Glyphs are black text on a white background
+      void addSample(std::string letter, const cv::Mat& glyph);
+
+      // The closest letters to the glyph, best first, with a confidence from 0-100
+      std::vector<OcrChoice> classify(const cv::Mat& glyph, unsigned int maxChoices);
+
+      bool load(std::string filename);
+      bool save(std::string filename);
+
+      int getSampleCount();
+
+    private:
+      static const int GRID_WIDTH = 10;
+      static const int GRID_HEIGHT = 16;
+      static const int FEATURE_COUNT = GRID_WIDTH * GRID_HEIGHT + 1;
+
+      // One row of features per sample
+      cv::Mat samples;
+      std::vector<std::string> labels;
+
+      bool getFeatures(const cv::Mat& glyph, cv::Mat& features);
+  };
+
+}
+
+#endif // OPENALPR_GLYPHCLASSIFIER_H
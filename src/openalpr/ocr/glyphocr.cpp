@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "glyphocr.h"
+
+using namespace std;
+using namespace cv;
+
+namespace alpr
+{
+
+  GlyphOcr::GlyphOcr(Config* config)
+  : OCR(config)
+  {
+    loaded = classifier.load(config->getGlyphClassifierFile());
+
+    if (loaded && config->debugOcr)
+      cout << "Loaded " << classifier.getSampleCount() << " glyph samples from " << config->getGlyphClassifierFile() << endl;
+  }
+
+  GlyphOcr::~GlyphOcr()
+  {
+  }
+
+  bool GlyphOcr::isLoaded()
+  {
+    return loaded;
+  }
+
+  void GlyphOcr::recognizeCharacters(const Mat& threshold, const vector<Rect>& charRegions, int thresholdIndex,
+                                     const vector<bool>& charsToRecognize, vector<vector<OcrChoice> >& charChoices)
+  {
+    const unsigned int MAX_CHOICES = 4;
+
+    for (unsigned int j = 0; j < charRegions.size(); j++)
+    {
+      if (charsToRecognize[j] == false)
+        continue;
+
+      // Same crop that openalpr-utils-classifychars saves for training
+      Rect charRegion = expandRect(charRegions[j], 0, 0, threshold.cols, threshold.rows);
+      if (charRegion.width <= 0 || charRegion.height <= 0)
+        continue;
+
+      vector<OcrChoice> choices = classifier.classify(threshold(charRegion), MAX_CHOICES);
+      if (choices.size() == 0)
+        continue;
+
+      // Add the best letter followed by every choice, the same as the Tesseract backend
+      // does with a symbol and its choice list, so the post processor scores are comparable
+      charChoices[j].push_back(choices[0]);
+      for (unsigned int c = 0; c < choices.size(); c++)
+        charChoices[j].push_back(choices[c]);
+
+      if (config->debugOcr)
+      {
+        printf("charpos%d: threshold %d:  symbol %s, conf: %f\n", j, thresholdIndex, choices[0].letter.c_str(), choices[0].confidence);
+        for (unsigned int c = 0; c < choices.size(); c++)
+          printf("\t- %s conf: %f\n", choices[c].letter.c_str(), choices[c].confidence);
+        printf("---------------------------------------------\n");
+      }
+    }
+  }
+
+}
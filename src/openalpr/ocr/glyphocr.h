@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_GLYPHOCR_H
+#define OPENALPR_GLYPHOCR_H
+
+#include "ocr.h"
+#include "glyphclassifier.h"
+
+namespace alpr
+{
+
+  // Classifies each character with the built-in glyph classifier rather than Tesseract
+  class GlyphOcr : public OCR
+  {
+
+    public:
+      GlyphOcr(Config* config);
+      virtual ~GlyphOcr();
+
+      bool isLoaded();
+
+    protected:
+      virtual void recognizeCharacters(const cv::Mat& threshold, const std::vector<cv::Rect>& charRegions, int thresholdIndex,
+                                       const std::vector<bool>& charsToRecognize, std::vector<std::vector<OcrChoice> >& charChoices);
+
+    private:
+      GlyphClassifier classifier;
+      bool loaded;
+
+  };
+
+}
+
+#endif // OPENALPR_GLYPHOCR_H
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ocrfactory.h"
+#include "tesseractocr.h"
+#include "glyphocr.h"
+
+namespace alpr
+{
+
+  OCR* createOcr(Config* config)
+  {
+    if (config->ocrBackend == OCR_BACKEND_GLYPH)
+    {
+      GlyphOcr* glyphOcr = new GlyphOcr(config);
+      if (glyphOcr->isLoaded())
+        return glyphOcr;
+
+      delete glyphOcr;
+      std::cerr << "Unable to load the glyph classifier model " << config->getGlyphClassifierFile() << ".  Using Tesseract" << std::endl;
+      return new TesseractOcr(config);
+    }
+    else
+    {
+      return new TesseractOcr(config);
+    }
+  }
+
+}
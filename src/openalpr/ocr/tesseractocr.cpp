@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tesseractocr.h"
+
+using namespace std;
+using namespace cv;
+using namespace tesseract;
+
+namespace alpr
+{
+
+  // The characters of one threshold that a thread recognizes with its own Tesseract instance
+  struct TesseractOcr::CharacterWork
+  {
+    tesseract::TessBaseAPI* api;
+
+    const Mat* threshold;
+    const vector<Rect>* charRegions;
+    int thresholdIndex;
+
+    // Positions to recognize.  Share n of N takes every Nth one, starting with the nth.
+    const vector<int>* charPositions;
+    unsigned int workerIndex;
+    unsigned int workerCount;
+
+    vector<vector<OcrChoice> >* charChoices;
+  };
+
+  // A worker thread that lives as long as the TesseractOcr and takes the share with its index
+  struct TesseractOcr::Worker
+  {
+    TesseractOcr* ocr;
+    unsigned int index;
+    tesseract::TessBaseAPI api;
+    tthread::thread* thread;
+  };
+
+  TesseractOcr::TesseractOcr(Config* config)
+  : OCR(config), currentWork(NULL), workGeneration(0), busyWorkers(0), stopWorkers(false)
+  {
+    const string EXPECTED_TESSERACT_VERSION = "3.03";
+
+    if (startsWith(tesseract.Version(), EXPECTED_TESSERACT_VERSION) == false)
+    {
+      std::cerr << "Warning: You are running an unsupported version of Tesseract." << endl;
+      std::cerr << "Expecting version " << EXPECTED_TESSERACT_VERSION << ", your version is: " << tesseract.Version() << endl;
+    }
+
+    initTesseract(&tesseract);
+
+    // This thread takes the first share of the work, so one worker fewer is needed
+    for (int i = 1; i < config->ocrThreads; i++)
+    {
+      Worker* worker = new Worker();
+      worker->ocr = this;
+      worker->index = i;
+      initTesseract(&worker->api);
+      workers.push_back(worker);
+    }
+
+    for (unsigned int i = 0; i < workers.size(); i++)
+      workers[i]->thread = new tthread::thread(workerThread, (void*) workers[i]);
+  }
+
+  TesseractOcr::~TesseractOcr()
+  {
+    {
+      tthread::lock_guard<tthread::mutex> guard(workMutex);
+      stopWorkers = true;
+      workReady.notify_all();
+    }
+
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+      workers[i]->thread->join();
+      delete workers[i]->thread;
+      workers[i]->api.End();
+      delete workers[i];
+    }
+
+    tesseract.Clear();
+  }
+
+  void TesseractOcr::initTesseract(TessBaseAPI* api)
+  {
+    // Tesseract requires the prefix directory to be set as an env variable
+    api->Init(config->getTessdataPrefix().c_str(), config->ocrLanguage.c_str() 	);
+    api->SetVariable("save_blob_choices", "T");
+    api->SetPageSegMode(PSM_SINGLE_CHAR);
+
+    // The adaptive classifier learns from every character an instance reads, so with several instances the
+    // results would depend on which instance got which character.  Without it, they are always the same.
+    // A single instance keeps learning, so the default serial results are unchanged.
+    if (config->ocrThreads > 1)
+      api->SetVariable("classify_enable_learning", "0");
+  }
+
+  void TesseractOcr::recognizeCharacters(const Mat& threshold, const vector<Rect>& charRegions, int thresholdIndex,
+                                         const vector<bool>& charsToRecognize, vector<vector<OcrChoice> >& charChoices)
+  {
+    vector<bool> recognized(charRegions.size());
+    for (unsigned int j = 0; j < charRegions.size(); j++)
+      recognized[j] = (charsToRecognize[j] == false);
+
+    if (config->ocrBatchCharacters)
+      recognizeCharacterStrip(threshold, charRegions, thresholdIndex, charChoices, recognized);
+
+    vector<int> charPositions;
+    for (unsigned int j = 0; j < charRegions.size(); j++)
+    {
+      if (recognized[j] == false)
+        charPositions.push_back(j);
+    }
+
+    if (charPositions.size() == 0)
+      return;
+
+    // Each share fills in the choices for its own char positions, so the letters reach the post
+    // processor in the same order no matter how the work is scheduled
+    unsigned int workerCount = min(workers.size() + 1, charPositions.size());
+    vector<CharacterWork> work(workerCount);
+    for (unsigned int w = 0; w < workerCount; w++)
+    {
+      work[w].api = (w == 0) ? &tesseract : &workers[w - 1]->api;
+      work[w].threshold = &threshold;
+      work[w].charRegions = &charRegions;
+      work[w].thresholdIndex = thresholdIndex;
+      work[w].charPositions = &charPositions;
+      work[w].workerIndex = w;
+      work[w].workerCount = workerCount;
+      work[w].charChoices = &charChoices;
+    }
+
+    if (workerCount > 1)
+    {
+      tthread::lock_guard<tthread::mutex> guard(workMutex);
+      currentWork = &work;
+      busyWorkers = workerCount - 1;
+      workGeneration++;
+      workReady.notify_all();
+    }
+
+    // This thread does the first share
+    recognizeAssignedCharacters(&work[0]);
+
+    if (workerCount > 1)
+    {
+      tthread::lock_guard<tthread::mutex> guard(workMutex);
+      while (busyWorkers > 0)
+        workDone.wait(workMutex);
+      currentWork = NULL;
+    }
+  }
+
+  void TesseractOcr::workerThread(void* worker)
+  {
+    Worker* w = (Worker*) worker;
+    w->ocr->runWorker(w);
+  }
+
+  // Waits for each new threshold and recognizes this worker's share of it, if it has one
+  void TesseractOcr::runWorker(Worker* worker)
+  {
+    unsigned int seenGeneration = 0;
+    while (true)
+    {
+      CharacterWork* work = NULL;
+      {
+        tthread::lock_guard<tthread::mutex> guard(workMutex);
+        while (stopWorkers == false && workGeneration == seenGeneration)
+          workReady.wait(workMutex);
+
+        if (stopWorkers)
+          return;
+
+        // A worker without a share may only wake after the threshold is done
+        seenGeneration = workGeneration;
+        if (currentWork != NULL && worker->index < currentWork->size())
+          work = &(*currentWork)[worker->index];
+      }
+
+      if (work == NULL)
+        continue;
+
+      recognizeAssignedCharacters(work);
+
+      tthread::lock_guard<tthread::mutex> guard(workMutex);
+      busyWorkers--;
+      if (busyWorkers == 0)
+        workDone.notify_all();
+    }
+  }
+
+  void TesseractOcr::recognizeAssignedCharacters(CharacterWork* work)
+  {
+    const Mat& threshold = *work->threshold;
+
+    work->api->SetImage((uchar*) threshold.data,
+                        threshold.size().width, threshold.size().height,
+                        threshold.channels(), threshold.step1());
+
+    for (unsigned int i = work->workerIndex; i < work->charPositions->size(); i += work->workerCount)
+    {
+      int charposition = (*work->charPositions)[i];
+      recognizeCharacter(work->api, threshold, (*work->charRegions)[charposition], work->thresholdIndex, charposition,
+                         (*work->charChoices)[charposition]);
+    }
+  }
+
+  // Recognizes a single character region of the threshold image currently set in the Tesseract instance
+  void TesseractOcr::recognizeCharacter(TessBaseAPI* api, const Mat& threshold, const Rect& charRegion,
+                                        int thresholdIndex, int charposition, vector<OcrChoice>& choices)
+  {
+    Rect expandedRegion = expandRect( charRegion, 2, 2, threshold.cols, threshold.rows) ;
+
+    api->SetRectangle(expandedRegion.x, expandedRegion.y, expandedRegion.width, expandedRegion.height);
+    api->Recognize(NULL);
+
+    tesseract::ResultIterator* ri = api->GetIterator();
+    tesseract::PageIteratorLevel level = tesseract::RIL_SYMBOL;
+    do
+    {
+      readSymbolChoices(ri, thresholdIndex, charposition, choices);
+    }
+    while((ri->Next(level)));
+
+    delete ri;
+  }
+
+  // Lays out the character regions that are not yet recognized side by side on a white strip and
+  // recognizes the strip as a single line of text.  Each symbol found is matched back to the character
+  // region it was copied from.  A character is marked as recognized only if exactly one symbol falls
+  // within its slot; the rest are left for the caller to recognize individually.
+  void TesseractOcr::recognizeCharacterStrip(const Mat& threshold, const vector<Rect>& charRegions, int thresholdIndex,
+                                             vector<vector<OcrChoice> >& charChoices, vector<bool>& recognized)
+  {
+    const int MIN_CHAR_SPACING_PX = 4;
+
+    vector<Rect> expandedRegions(charRegions.size());
+    vector<bool> pending(charRegions.size(), false);
+    int minY = threshold.rows;
+    int maxY = 0;
+    int maxWidth = 0;
+    int pendingChars = 0;
+    for (unsigned int j = 0; j < charRegions.size(); j++)
+    {
+      if (recognized[j])
+        continue;
+
+      // A region that is empty once clipped to the image is left for the caller
+      expandedRegions[j] = expandRect( charRegions[j], 2, 2, threshold.cols, threshold.rows);
+      if (expandedRegions[j].width <= 0 || expandedRegions[j].height <= 0)
+        continue;
+
+      pending[j] = true;
+      pendingChars++;
+      minY = min(minY, expandedRegions[j].y);
+      maxY = max(maxY, expandedRegions[j].y + expandedRegions[j].height);
+      maxWidth = max(maxWidth, expandedRegions[j].width);
+    }
+
+    // A single character is recognized just as quickly on its own
+    if (pendingChars < 2)
+      return;
+
+    // Leave enough white space around each character that it is read as a separate symbol.
+    // Characters keep their vertical position so that the baseline and font size are unchanged.
+    int spacing = max(maxWidth / 2, MIN_CHAR_SPACING_PX);
+
+    vector<int> slotX(charRegions.size(), -1);
+    int stripWidth = spacing;
+    for (unsigned int j = 0; j < expandedRegions.size(); j++)
+    {
+      if (pending[j] == false)
+        continue;
+
+      slotX[j] = stripWidth;
+      stripWidth += expandedRegions[j].width + spacing;
+    }
+
+    batchStrip.create(Size(stripWidth, (maxY - minY) + (2 * spacing)), CV_8U);
+    batchStrip.setTo(Scalar(255));
+    for (unsigned int j = 0; j < expandedRegions.size(); j++)
+    {
+      if (pending[j] == false)
+        continue;
+
+      Rect slot(slotX[j], spacing + expandedRegions[j].y - minY, expandedRegions[j].width, expandedRegions[j].height);
+      threshold(expandedRegions[j]).copyTo(batchStrip(slot));
+    }
+
+    tesseract.SetPageSegMode(PSM_SINGLE_LINE);
+    tesseract.SetImage((uchar*) batchStrip.data, batchStrip.cols, batchStrip.rows, batchStrip.channels(), batchStrip.step1());
+    tesseract.Recognize(NULL);
+
+    vector<vector<OcrChoice> > stripChoices(charRegions.size());
+    vector<int> symbolCounts(charRegions.size(), 0);
+    bool ambiguous = false;
+
+    tesseract::ResultIterator* ri = tesseract.GetIterator();
+    tesseract::PageIteratorLevel level = tesseract::RIL_SYMBOL;
+    if (ri != NULL)
+    {
+      do
+      {
+        int left, top, right, bottom;
+        if (ri->BoundingBox(level, &left, &top, &right, &bottom) == false)
+          continue;
+
+        // The slot, including half of the spacing on either side, must contain the whole symbol
+        int charposition = -1;
+        for (unsigned int j = 0; j < slotX.size(); j++)
+        {
+          if (slotX[j] >= 0 && left >= slotX[j] - spacing / 2 && right <= slotX[j] + expandedRegions[j].width + spacing / 2)
+          {
+            charposition = j;
+            break;
+          }
+        }
+
+        if (charposition < 0)
+        {
+          // A symbol that spans several characters can't be attributed to any one of them
+          ambiguous = true;
+          break;
+        }
+
+        if (readSymbolChoices(ri, thresholdIndex, charposition, stripChoices[charposition]))
+          symbolCounts[charposition]++;
+      }
+      while((ri->Next(level)));
+
+      delete ri;
+    }
+
+    tesseract.SetPageSegMode(PSM_SINGLE_CHAR);
+
+    if (ambiguous)
+    {
+      if (config->debugOcr)
+        printf("threshold %d: symbols could not be matched to characters, recognizing each character separately\n", thresholdIndex);
+      return;
+    }
+
+    for (unsigned int j = 0; j < charRegions.size(); j++)
+    {
+      if (pending[j] == false)
+        continue;
+
+      if (symbolCounts[j] == 1)
+      {
+        charChoices[j] = stripChoices[j];
+        recognized[j] = true;
+      }
+      else if (config->debugOcr)
+      {
+        printf("charpos%d: threshold %d: %d symbols in batch, recognizing separately\n", j, thresholdIndex, symbolCounts[j]);
+      }
+    }
+  }
+
+  // Adds the symbol at the iterator, followed by all of its choices, to the list.
+  // Returns false if the symbol was ignored.
+  bool TesseractOcr::readSymbolChoices(tesseract::ResultIterator* ri, int thresholdIndex, int charposition, vector<OcrChoice>& choices)
+  {
+    const int SPACE_CHAR_CODE = 32;
+
+    tesseract::PageIteratorLevel level = tesseract::RIL_SYMBOL;
+
+    const char* symbol = ri->GetUTF8Text(level);
+    float conf = ri->Confidence(level);
+
+    bool dontcare;
+    int fontindex = 0;
+    int pointsize = 0;
+    const char* fontName = ri->WordFontAttributes(&dontcare, &dontcare, &dontcare, &dontcare, &dontcare, &dontcare, &pointsize, &fontindex);
+
+    // Ignore NULL pointers, spaces, and characters that are way too small to be valid
+    bool validSymbol = (symbol != 0 && symbol[0] != SPACE_CHAR_CODE && pointsize >= config->ocrMinFontSize);
+    if(validSymbol)
+    {
+      OcrChoice symbolChoice;
+      symbolChoice.letter = string(symbol);
+      symbolChoice.confidence = conf;
+      choices.push_back(symbolChoice);
+
+      if (this->config->debugOcr)
+        printf("charpos%d: threshold %d:  symbol %s, conf: %f font: %s (index %d) size %dpx", charposition, thresholdIndex, symbol, conf, fontName, fontindex, pointsize);
+
+      bool indent = false;
+      tesseract::ChoiceIterator ci(*ri);
+      do
+      {
+        const char* choice = ci.GetUTF8Text();
+
+        OcrChoice alternative;
+        alternative.letter = string(choice);
+        alternative.confidence = ci.Confidence();
+        choices.push_back(alternative);
+
+        //letterScores.addScore(*choice, j, ci.Confidence() - MIN_CONFIDENCE);
+        if (this->config->debugOcr)
+        {
+          if (indent) printf("\t\t ");
+          printf("\t- ");
+          printf("%s conf: %f\n", choice, ci.Confidence());
+        }
+
+        indent = true;
+      }
+      while(ci.Next());
+    }
+
+    if (this->config->debugOcr)
+      printf("---------------------------------------------\n");
+
+    delete[] symbol;
+
+    return validSymbol;
+  }
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_TESSERACTOCR_H
+#define OPENALPR_TESSERACTOCR_H
+
+#include "ocr.h"
+
+#include "tesseract/baseapi.h"
+#include "support/tinythread.h"
+
+namespace alpr
+{
+
+  class TesseractOcr : public OCR
+  {
+
+    public:
+      TesseractOcr(Config* config);
+      virtual ~TesseractOcr();
+
+    protected:
+      virtual void recognizeCharacters(const cv::Mat& threshold, const std::vector<cv::Rect>& charRegions, int thresholdIndex,
+                                       const std::vector<bool>& charsToRecognize, std::vector<std::vector<OcrChoice> >& charChoices);
+
+    private:
+      tesseract::TessBaseAPI tesseract;
+
+      // Long-lived worker threads, each with its own Tesseract instance, when ocr_threads > 1
+      struct Worker;
+      std::vector<Worker*> workers;
+
+      // Work shared with the workers for the threshold being recognized.  Guarded by workMutex.
+      struct CharacterWork;
+      tthread::mutex workMutex;
+      tthread::condition_variable workReady;
+      tthread::condition_variable workDone;
+      std::vector<CharacterWork>* currentWork;
+      unsigned int workGeneration;
+      unsigned int busyWorkers;
+      bool stopWorkers;
+
+      static void workerThread(void* worker);
+      void runWorker(Worker* worker);
+      void recognizeAssignedCharacters(CharacterWork* work);
+
+      void initTesseract(tesseract::TessBaseAPI* api);
+
+      // White background strip that the characters of a threshold are laid out on for batched OCR
+      cv::Mat batchStrip;
+
+      void recognizeCharacter(tesseract::TessBaseAPI* api, const cv::Mat& threshold, const cv::Rect& charRegion,
+                              int thresholdIndex, int charposition, std::vector<OcrChoice>& choices);
+      void recognizeCharacterStrip(const cv::Mat& threshold, const std::vector<cv::Rect>& charRegions, int thresholdIndex,
+                                   std::vector<std::vector<OcrChoice> >& charChoices, std::vector<bool>& recognized);
+
+      bool readSymbolChoices(tesseract::ResultIterator* ri, int thresholdIndex, int charposition, std::vector<OcrChoice>& choices);
+
+  };
+
+}
+
+#endif // OPENALPR_TESSERACTOCR_H
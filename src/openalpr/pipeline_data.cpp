@@ -41,6 +41,39 @@ namespace alpr
     thresholds.clear();
   }
 
+  void PipelineData::reset(Mat colorImage, Mat grayImage, Rect regionOfInterest, Config* config)
+  {
+    releaseImages();
+
+    this->init(colorImage, grayImage, regionOfInterest, config);
+    this->isMultiline = false;
+    this->hasPlateBorder = false;
+    this->region_code = "";
+    this->region_confidence = 0;
+
+    textLines.clear();
+    plate_corners.clear();
+    charRegions.clear();
+    confidence_weights.clear();
+  }
+
+  void PipelineData::releaseImages()
+  {
+    colorImg.release();
+    grayImg.release();
+    crop_gray.release();
+    plateBorderMask.release();
+    clearThresholds();
+  }
+
+  void PipelineData::prepareThresholds(int firstSlot)
+  {
+    thresholds.resize(THRESHOLD_COUNT);
+
+    for (int i = 0; i < THRESHOLD_COUNT; i++)
+      thresholds[i] = scratch.get(firstSlot + i, crop_gray.size(), CV_8U);
+  }
+
   void PipelineData::init(cv::Mat colorImage, cv::Mat grayImage, cv::Rect regionOfInterest, Config *config) {
     this->colorImg = colorImage;
     this->grayImg = grayImage;
@@ -50,5 +83,6 @@ namespace alpr
     this->plate_inverted = false;
     this->disqualified = false;
     this->disqualify_reason = "";
+    this->ocrThresholdsUsed = 0;
   }
 }
@@ -7,6 +7,7 @@
 #include "config.h"
 #include "textdetection/textline.h"
 #include "edges/scorekeeper.h"
+#include "scratcharena.h"
 
 namespace alpr
 {
@@ -22,6 +23,27 @@ namespace alpr
       void init(cv::Mat colorImage, cv::Mat grayImage, cv::Rect regionOfInterest, Config* config);
       void clearThresholds();
 
+      // Prepares the data for another plate.  The containers and scratch buffers keep the
+      // memory they grew to, so a reused PipelineData stops allocating once it has warmed up.
+      void reset(cv::Mat colorImage, cv::Mat grayImage, cv::Rect regionOfInterest, Config* config);
+
+      // Drops the references to the input image and the plate images, leaving the scratch buffers
+      void releaseImages();
+
+      // Points the thresholds at THRESHOLD_COUNT scratch buffers the size of crop_gray, starting at firstSlot
+      void prepareThresholds(int firstSlot);
+
+      // Scratch arena slots shared by the plate stages.  The stages number their own slots
+      // from zero, so these start above them.  Text analysis and segmentation threshold crops of
+      // different sizes, so each keeps its own thresholds.
+      enum ScratchSlot
+      {
+        SCRATCH_TEMPLATE_CROP = 16,
+        SCRATCH_DESKEWED_CROP,
+        SCRATCH_ANALYSIS_THRESHOLDS,
+        SCRATCH_SEGMENTATION_THRESHOLDS = SCRATCH_ANALYSIS_THRESHOLDS + THRESHOLD_COUNT
+      };
+
       // Inputs
       Config* config;
 
@@ -55,10 +77,15 @@ namespace alpr
 
       std::vector<cv::Rect> charRegions;
 
+      // Reusable image buffers for the analysis stages of this plate
+      ScratchArena scratch;
+
 
 
 
       // OCR
+      // Number of thresholds read before the OCR was confident in every character
+      int ocrThresholdsUsed;
 
   };
 
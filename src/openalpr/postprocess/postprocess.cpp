@@ -27,6 +27,9 @@ namespace alpr
   PostProcess::PostProcess(Config* config)
   {
     this->config = config;
+    this->keyWords = 1;
+    this->visitedCount = 0;
+    this->templateRules = NULL;
 
     stringstream filename;
     filename << config->getPostProcessRuntimeDir() << "/" << config->country << ".patterns";
@@ -72,12 +75,13 @@ namespace alpr
     }
   }
 
-  void PostProcess::addLetter(string letter, int charposition, float score)
+  void PostProcess::addLetter(string letter, int charposition, float score, bool fitsRegion)
   {
     if (score < config->postProcessMinConfidence)
       return;
 
-    insertLetter(letter, charposition, score);
+    if (fitsRegion)
+      insertLetter(letter, charposition, score);
 
     if (score < config->postProcessConfidenceSkipLevel)
     {
@@ -154,6 +158,11 @@ namespace alpr
     timespec startTime;
     getTimeMonotonic(&startTime);
 
+    unknownCharPositions.clear();
+    allPossibilities.clear();
+    allPossibilitiesLetters.clear();
+    bestChars = "";
+
     // Get a list of missing positions
     for (int i = letters.size() -1; i >= 0; i--)
     {
@@ -173,6 +182,8 @@ namespace alpr
         sort(letters[i].begin(), letters[i].end(), letterCompare);
     }
 
+    internLetters();
+
     if (this->config->debugPostProcess)
     {
       // Print all letters
@@ -247,6 +258,39 @@ namespace alpr
     return rules.find(templateregion) != rules.end();
   }
   
+  bool PostProcess::letterFitsRegion(string templateregion, string letter, int charposition, int charPositionCount)
+  {
+    map<string, vector<RegexRule*> >::iterator regionRules = rules.find(templateregion);
+    if (regionRules == rules.end())
+      return true;
+
+    bool anyRuleFits = false;
+    for (unsigned int i = 0; i < regionRules->second.size(); i++)
+    {
+      RegexRule* rule = regionRules->second[i];
+
+      int length = rule->getLength();
+      if (length == 0 || length > charPositionCount)
+        continue;
+
+      anyRuleFits = true;
+
+      // With the extra char positions skipped, this one lines up with a pattern position between
+      // (charposition - skips) and charposition
+      int skips = charPositionCount - length;
+      int firstPosition = max(0, charposition - skips);
+      int lastPosition = min(charposition, length - 1);
+      for (int p = firstPosition; p <= lastPosition; p++)
+      {
+        if (rule->matchesPosition(p, letter))
+          return true;
+      }
+    }
+
+    // If none of the patterns can fit the plate, no letter can be ruled out
+    return anyRuleFits == false;
+  }
+
   float PostProcess::calculateMaxConfidenceScore()
   {
     // Take the best score for each char position and average it.
@@ -269,13 +313,18 @@ namespace alpr
     return totalScore / ((float) numScores);
   }
 
-  const vector<PPResult> PostProcess::getResults()
+  const vector<PPResult>& PostProcess::getResults()
   {
     return this->allPossibilities;
   }
 
+  const vector<vector<Letter> >& PostProcess::getLetters()
+  {
+    return this->letters;
+  }
+
   struct PermutationCompare {
-    bool operator() (pair<float,vector<int> > &a, pair<float,vector<int> > &b)
+    bool operator() (const pair<float,int> &a, const pair<float,int> &b)
     {
       return (a.first < b.first);
     }
@@ -283,9 +332,45 @@ namespace alpr
 
   void PostProcess::findAllPermutations(string templateregion, int topn) {
 
-    // use a priority queue to process permutations in highest scoring order
-    priority_queue<pair<float,vector<int> >, vector<pair<float,vector<int> > >, PermutationCompare> permutations;
-    set<float> permutationHashes;
+    templateRules = NULL;
+    if (templateregion != "")
+    {
+      map<string, vector<RegexRule*> >::iterator regionRules = rules.find(templateregion);
+      if (regionRules != rules.end())
+        templateRules = &regionRules->second;
+    }
+
+    // Give each char position a bit field wide enough for its letter indices.  Fields don't cross words.
+    fieldWord.resize(letters.size());
+    fieldShift.resize(letters.size());
+    fieldMask.resize(letters.size());
+    keyWords = 1;
+    int shift = 0;
+    for (int i = 0; i < letters.size(); i++)
+    {
+      int bits = 0;
+      while ((1u << bits) < letters[i].size())
+        bits++;
+
+      if (shift + bits > 64)
+      {
+        keyWords++;
+        shift = 0;
+      }
+
+      fieldWord[i] = keyWords - 1;
+      fieldShift[i] = shift;
+      fieldMask[i] = (((uint64_t) 1) << bits) - 1;
+      shift += bits;
+    }
+
+    keyPool.clear();
+    permutationHeap.clear();
+    visitedTable.assign(64, -1);
+    visitedCount = 0;
+
+    // use a heap to process permutations in highest scoring order
+    PermutationCompare permutationCompare;
 
     // push the first word onto the queue
     float totalscore = 0;
@@ -294,19 +379,21 @@ namespace alpr
       if (letters[i].size() > 0)
         totalscore += letters[i][0].totalscore;
     }
-    vector<int> v(letters.size());
-    permutations.push(make_pair(totalscore, v));
+    keyPool.resize(keyWords, 0);
+    addVisited(0);
+    permutationHeap.push_back(make_pair(totalscore, 0));
 
     int consecutiveNonMatches = 0;
-    while (permutations.size() > 0)
+    while (permutationHeap.size() > 0)
     {
       // get the top permutation and analyze
-      pair<float, vector<int> > topPermutation = permutations.top();
+      pair<float, int> topPermutation = permutationHeap.front();
       if (analyzePermutation(topPermutation.second, templateregion, topn) == true)
         consecutiveNonMatches = 0;
       else
         consecutiveNonMatches += 1;
-      permutations.pop();
+      pop_heap(permutationHeap.begin(), permutationHeap.end(), permutationCompare);
+      permutationHeap.pop_back();
 
       if (allPossibilities.size() >= topn || consecutiveNonMatches >= 10)
         break;
@@ -314,25 +401,125 @@ namespace alpr
       // add child permutations to queue
       for (int i=0; i<letters.size(); i++)
       {
+        int letterIndex = getLetterIndex(topPermutation.second, i);
+
         // no more permutations with this letter
-        if (topPermutation.second[i]+1 >= letters[i].size())
+        if (letterIndex + 1 >= letters[i].size())
           continue;
 
-        pair<float, vector<int> > childPermutation = topPermutation;
-        childPermutation.first -= letters[i][topPermutation.second[i]].totalscore - letters[i][topPermutation.second[i] + 1].totalscore;
-        childPermutation.second[i] += 1;
+        int child = keyPool.size() / keyWords;
+        for (int w = 0; w < keyWords; w++)
+        {
+          uint64_t word = keyPool[topPermutation.second * keyWords + w];
+          keyPool.push_back(word);
+        }
+        keyPool[child * keyWords + fieldWord[i]] += ((uint64_t) 1) << fieldShift[i];
 
-        // ignore permutations that have already been visited (assume that score is a good hash for permutation)
-        if (permutationHashes.end() != permutationHashes.find(childPermutation.first))
+        // ignore permutations that have already been queued
+        if (addVisited(child) == false)
+        {
+          keyPool.resize(child * keyWords);
           continue;
+        }
+
+        float childScore = topPermutation.first;
+        childScore -= letters[i][letterIndex].totalscore - letters[i][letterIndex + 1].totalscore;
 
-        permutations.push(childPermutation);
-        permutationHashes.insert(childPermutation.first);
+        permutationHeap.push_back(make_pair(childScore, child));
+        push_heap(permutationHeap.begin(), permutationHeap.end(), permutationCompare);
       }
     }
   }
 
-  bool PostProcess::analyzePermutation(vector<int> letterIndices, string templateregion, int topn)
+  int PostProcess::getLetterIndex(int permutation, int charposition)
+  {
+    uint64_t word = keyPool[permutation * keyWords + fieldWord[charposition]];
+    return (int) ((word >> fieldShift[charposition]) & fieldMask[charposition]);
+  }
+
+  unsigned int PostProcess::hashPermutation(int permutation)
+  {
+    // FNV-1a over the key bytes
+    unsigned int hash = 2166136261u;
+    for (int w = 0; w < keyWords; w++)
+    {
+      uint64_t word = keyPool[permutation * keyWords + w];
+      for (int b = 0; b < 8; b++)
+      {
+        hash = (hash ^ (unsigned int) (word & 0xFF)) * 16777619u;
+        word = word >> 8;
+      }
+    }
+
+    return hash;
+  }
+
+  // Adds the permutation to the visited table.  Returns false if an identical one is already there.
+  bool PostProcess::addVisited(int permutation)
+  {
+    if ((visitedCount + 1) * 2 > visitedTable.size())
+    {
+      vector<int> oldTable;
+      oldTable.swap(visitedTable);
+      visitedTable.assign(oldTable.size() * 2, -1);
+      visitedCount = 0;
+
+      for (unsigned int i = 0; i < oldTable.size(); i++)
+      {
+        if (oldTable[i] != -1)
+          addVisited(oldTable[i]);
+      }
+    }
+
+    unsigned int mask = visitedTable.size() - 1;
+    unsigned int slot = hashPermutation(permutation) & mask;
+    while (visitedTable[slot] != -1)
+    {
+      vector<uint64_t>::iterator existing = keyPool.begin() + visitedTable[slot] * keyWords;
+      if (equal(existing, existing + keyWords, keyPool.begin() + permutation * keyWords))
+        return false;
+
+      slot = (slot + 1) & mask;
+    }
+
+    visitedTable[slot] = permutation;
+    visitedCount++;
+    return true;
+  }
+
+  // Decodes the UTF-8 of every letter once, so the templates can be checked one codepoint at a time
+  void PostProcess::internLetters()
+  {
+    letterSlot.resize(letters.size());
+    letterCodepointStart.clear();
+    letterCodepoints.clear();
+
+    for (int i = 0; i < letters.size(); i++)
+    {
+      letterSlot[i] = letterCodepointStart.size();
+
+      for (int j = 0; j < letters[i].size(); j++)
+      {
+        letterCodepointStart.push_back(letterCodepoints.size());
+
+        const string& letter = letters[i][j].letter;
+        try
+        {
+          string::const_iterator utf_iterator = letter.begin();
+          while (utf_iterator != letter.end())
+            letterCodepoints.push_back(utf8::next(utf_iterator, letter.end()));
+        }
+        catch (utf8::exception& e)
+        {
+          letterCodepoints.push_back(-1);
+        }
+      }
+    }
+
+    letterCodepointStart.push_back(letterCodepoints.size());
+  }
+
+  bool PostProcess::analyzePermutation(int permutation, string templateregion, int topn)
   {
     PPResult possibility;
     possibility.letters = "";
@@ -340,18 +527,29 @@ namespace alpr
     possibility.matchesTemplate = false;
     int plate_char_length = 0;
 
+    // The letters are checked against the templates as they are added, so a rule is dropped
+    // at the first letter that doesn't fit it rather than testing the complete string
+    candidateRules.clear();
+    if (templateRules != NULL)
+      candidateRules.insert(candidateRules.end(), templateRules->begin(), templateRules->end());
+    int codepointPosition = 0;
+
     for (int i = 0; i < letters.size(); i++)
     {
       if (letters[i].size() == 0)
         continue;
 
-      Letter letter = letters[i][letterIndices[i]];
+      int letterIndex = getLetterIndex(permutation, i);
+      const Letter& letter = letters[i][letterIndex];
 
       if (letter.letter != SKIP_CHAR)
       {
         possibility.letters = possibility.letters + letter.letter;
         possibility.letter_details.push_back(letter);
         plate_char_length += 1;
+
+        if (candidateRules.size() > 0)
+          removeUnfitRules(letterSlot[i] + letterIndex, codepointPosition);
       }
       possibility.totalscore = possibility.totalscore + letter.totalscore;
     }
@@ -361,19 +559,14 @@ namespace alpr
       plate_char_length > config->postProcessMaxCharacters)
       return false;
 
-    // Apply templates
-    if (templateregion != "")
+    // Apply templates.  The first remaining rule of the right length matches the whole string.
+    for (int i = 0; i < candidateRules.size(); i++)
     {
-      vector<RegexRule*> regionRules = rules[templateregion];
-
-      for (int i = 0; i < regionRules.size(); i++)
+      if (candidateRules[i]->getLength() == codepointPosition)
       {
-        possibility.matchesTemplate = regionRules[i]->match(possibility.letters);
-        if (possibility.matchesTemplate)
-        {
-          possibility.letters = regionRules[i]->filterSkips(possibility.letters);
-          break;
-        }
+        possibility.matchesTemplate = true;
+        possibility.letters = candidateRules[i]->filterSkips(possibility.letters);
+        break;
       }
     }
 
@@ -386,6 +579,25 @@ namespace alpr
     return true;
   }
 
+  // Removes the candidate rules that don't fit the interned letter, which starts at the given codepoint position
+  void PostProcess::removeUnfitRules(int slot, int& codepointPosition)
+  {
+    for (int c = letterCodepointStart[slot]; c < letterCodepointStart[slot + 1]; c++)
+    {
+      int cp = letterCodepoints[c];
+
+      unsigned int kept = 0;
+      for (unsigned int i = 0; i < candidateRules.size() && cp >= 0; i++)
+      {
+        if (candidateRules[i]->matchesPosition(codepointPosition, cp))
+          candidateRules[kept++] = candidateRules[i];
+      }
+      candidateRules.resize(kept);
+
+      codepointPosition++;
+    }
+  }
+
   bool wordCompare( const PPResult &left, const PPResult &right )
   {
     if (left.totalscore < right.totalscore)
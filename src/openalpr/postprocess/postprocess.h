@@ -29,6 +29,8 @@
 #include <queue>
 #include <vector>
 #include <set>
+#include <algorithm>
+#include <stdint.h>
 #include "config.h"
 
 
@@ -63,28 +65,72 @@ namespace alpr
       PostProcess(Config* config);
       ~PostProcess();
 
-      void addLetter(std::string letter, int charposition, float score);
+      // A letter that doesn't fit the region's patterns is not inserted, but still adds the skip
+      // position that its low score calls for
+      void addLetter(std::string letter, int charposition, float score, bool fitsRegion = true);
 
       void clear();
+
+      // Finds the topn plates for the letters added since the last clear().  Can be run again on
+      // the same letters, for instance with a different topn.
       void analyze(std::string templateregion, int topn);
 
       std::string bestChars;
       bool matchesTemplate;
 
-      const std::vector<PPResult> getResults();
+      // Valid until the next analyze or clear
+      const std::vector<PPResult>& getResults();
+
+      // The letters added at each char position, best first once analyze has run.  Valid until the next addLetter or clear.
+      const std::vector<std::vector<Letter> >& getLetters();
 
       bool regionIsValid(std::string templateregion);
+
+      // True if the letter could appear at the char position in one of the region's patterns, on a plate
+      // with charPositionCount char positions of which any may turn out to be skipped
+      bool letterFitsRegion(std::string templateregion, std::string letter, int charposition, int charPositionCount);
       
     private:
       Config* config;
       //void getTopN();
       void findAllPermutations(std::string templateregion, int topn);
-      bool analyzePermutation(std::vector<int> letterIndices, std::string templateregion, int topn);
+      bool analyzePermutation(int permutation, std::string templateregion, int topn);
 
       void insertLetter(std::string letter, int charPosition, float score);
 
       std::map<std::string, std::vector<RegexRule*> > rules;
 
+      // Permutations are stored in keyPool as keyWords words each, with the letter index for every
+      // char position packed into its own bit field.  The buffers are kept from one plate to the next.
+      std::vector<uint64_t> keyPool;
+      int keyWords;
+      std::vector<int> fieldWord;
+      std::vector<int> fieldShift;
+      std::vector<uint64_t> fieldMask;
+
+      int getLetterIndex(int permutation, int charposition);
+
+      // Heap of (score, permutation) still to be analyzed
+      std::vector<std::pair<float, int> > permutationHeap;
+
+      // Open addressing hash table of the permutations queued so far, -1 for an empty slot
+      std::vector<int> visitedTable;
+      int visitedCount;
+      unsigned int hashPermutation(int permutation);
+      bool addVisited(int permutation);
+
+      // The codepoints of letters[i][j] are letterCodepoints[letterCodepointStart[letterSlot[i] + j]] up to
+      // the start of the next letter.  -1 stands in for invalid UTF-8.
+      std::vector<int> letterSlot;
+      std::vector<int> letterCodepointStart;
+      std::vector<int> letterCodepoints;
+      void internLetters();
+
+      // The region's rules that the letters of the permutation being analyzed still fit
+      std::vector<RegexRule*>* templateRules;
+      std::vector<RegexRule*> candidateRules;
+      void removeUnfitRules(int slot, int& codepointPosition);
+
       float calculateMaxConfidenceScore();
 
       std::vector<std::vector<Letter> > letters;
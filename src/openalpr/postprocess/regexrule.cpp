@@ -18,6 +18,7 @@
 */
 
 #include "regexrule.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -25,7 +26,124 @@ tthread::mutex regexrule_mutex_m;
 
 namespace alpr
 {
-   
+
+  CharacterClass::CharacterClass()
+  {
+    memset(ascii, 0, sizeof(ascii));
+    any = false;
+    alpha = false;
+    digit = false;
+    negated = false;
+  }
+
+  bool CharacterClass::compile(string position_regex)
+  {
+    if (position_regex == "\\p{Alpha}")
+    {
+      alpha = true;
+      addRange('A', 'Z');
+      addRange('a', 'z');
+      return true;
+    }
+    else if (position_regex == "\\p{Digit}")
+    {
+      digit = true;
+      addRange('0', '9');
+      return true;
+    }
+    else if (position_regex == ".")
+    {
+      // Anything but a newline
+      any = true;
+      addRange(0, '\n' - 1);
+      addRange('\n' + 1, 127);
+      return true;
+    }
+
+    vector<int> codepoints;
+    string::iterator utf_iterator = position_regex.begin();
+    while (utf_iterator != position_regex.end())
+      codepoints.push_back(utf8::next(utf_iterator, position_regex.end()));
+
+    if (codepoints.size() == 1)
+    {
+      // A literal character, unless it is regex syntax
+      if (codepoints[0] < 128 && strchr(".^$|()[]{}*+?\\", codepoints[0]) != NULL)
+        return false;
+
+      addRange(codepoints[0], codepoints[0]);
+      return true;
+    }
+
+    if (codepoints.size() < 3 || codepoints[0] != '[' || codepoints[codepoints.size() - 1] != ']')
+      return false;
+
+    unsigned int first = 1;
+    unsigned int end = codepoints.size() - 1;
+    if (codepoints[first] == '^')
+    {
+      negated = true;
+      first++;
+    }
+
+    if (first == end)
+      return false;
+
+    for (unsigned int i = first; i < end; i++)
+    {
+      int cp = codepoints[i];
+
+      // Escapes, nested classes and intersections are left to the regex
+      if (cp == '\\' || cp == '[' || (cp == '&' && i + 1 < end && codepoints[i + 1] == '&'))
+        return false;
+
+      if (i + 2 < end && codepoints[i + 1] == '-')
+      {
+        if (codepoints[i + 2] < cp)
+          return false;
+
+        addRange(cp, codepoints[i + 2]);
+        i += 2;
+      }
+      else
+      {
+        addRange(cp, cp);
+      }
+    }
+
+    if (negated)
+    {
+      for (int i = 0; i < 4; i++)
+        ascii[i] = ~ascii[i];
+    }
+
+    return true;
+  }
+
+  bool CharacterClass::contains(int codepoint) const
+  {
+    if (codepoint >= 0 && codepoint < 128)
+      return ((ascii[codepoint >> 5] >> (codepoint & 31)) & 1) != 0;
+
+    bool found = any ||
+                 (alpha && ONIGENC_IS_CODE_ALPHA(ONIG_ENCODING_UTF8, codepoint)) ||
+                 (digit && ONIGENC_IS_CODE_DIGIT(ONIG_ENCODING_UTF8, codepoint));
+
+    for (unsigned int i = 0; i < ranges.size() && found == false; i++)
+      found = codepoint >= ranges[i].first && codepoint <= ranges[i].second;
+
+    return found != negated;
+  }
+
+  void CharacterClass::addRange(int first, int last)
+  {
+    for (int cp = first; cp <= last && cp < 128; cp++)
+      ascii[cp >> 5] |= 1u << (cp & 31);
+
+    if (last >= 128)
+      ranges.push_back(make_pair(max(first, 128), last));
+  }
+
   RegexRule::RegexRule(string region, string pattern)
   {   
     this->original = pattern;
@@ -41,8 +159,15 @@ namespace alpr
     
     string::iterator utf_iterator = pattern.begin();
     numchars = 0;
+    vector<string> position_patterns;
+    size_t position_start = 0;
+    bool escaped = false;
     while (utf_iterator < pattern.end())
     {
+      if (escaped == false)
+        position_start = this->regex.size();
+      escaped = false;
+
       int cp = utf8::next(utf_iterator, pattern.end());
       
       string utf_character = utf8chr(cp);
@@ -66,6 +191,7 @@ namespace alpr
       {
         // Don't add "\" characters to our character count
         this->regex = this->regex + utf_character;
+        escaped = true;
         continue;
       }
       else if (utf_character == "?")
@@ -91,16 +217,32 @@ namespace alpr
       }
 
       numchars++;
+      position_patterns.push_back(this->regex.substr(position_start));
+    }
+
+    for (unsigned int i = 0; i < position_patterns.size(); i++)
+    {
+      CharacterClass position_class;
+      position_compiled.push_back(position_class.compile(position_patterns[i]));
+      position_classes.push_back(position_class);
     }
 
     // Onigurama is not thread safe when compiling regex.  Using a mutex to ensure that
     // we don't crash
     regexrule_mutex_m.lock();
-    UChar* cstr_pattern = (UChar* )this->regex.c_str();
     OnigErrorInfo einfo;
+    int r = ONIG_NORMAL;
+
+    for (unsigned int i = 0; i < position_patterns.size() && r == ONIG_NORMAL; i++)
+    {
+      regex_t* position_regex;
+      UChar* cstr_position = (UChar* ) position_patterns[i].c_str();
+      r = onig_new(&position_regex, cstr_position, cstr_position + position_patterns[i].size(),
+        ONIG_OPTION_DEFAULT, ONIG_ENCODING_UTF8, ONIG_SYNTAX_DEFAULT, &einfo);
 
-    int r = onig_new(&onig_regex, cstr_pattern, cstr_pattern + strlen((char* )cstr_pattern),
-      ONIG_OPTION_DEFAULT, ONIG_ENCODING_UTF8, ONIG_SYNTAX_DEFAULT, &einfo);
+      if (r == ONIG_NORMAL)
+        position_regexes.push_back(position_regex);
+    }
 
     regexrule_mutex_m.unlock(); 
     
@@ -118,7 +260,9 @@ namespace alpr
   
   RegexRule::~RegexRule()
   {
-    onig_free(onig_regex);
+    for (unsigned int i = 0; i < position_regexes.size(); i++)
+      onig_free(position_regexes[i]);
+
     onig_end();
   }
 
@@ -126,29 +270,67 @@ namespace alpr
   {
     if (!this->valid)
       return false;
-    
-    string::iterator end_it = utf8::find_invalid(text.begin(), text.end());
-    if (end_it != text.end()) {
+
+    int position = 0;
+    try
+    {
+      string::iterator utf_iterator = text.begin();
+      while (utf_iterator != text.end())
+      {
+        if (matchesPosition(position, (int) utf8::next(utf_iterator, text.end())) == false)
+          return false;
+
+        position++;
+      }
+    }
+    catch (utf8::exception& e)
+    {
       cerr << "Invalid UTF-8 encoding detected " << endl;
       return false;
     }
-   
-    int text_char_length = utf8::distance(text.begin(), text.end());
 
-    if (text_char_length != numchars)
+    return position == numchars;
+  }
+
+  int RegexRule::getLength()
+  {
+    return numchars;
+  }
+
+  bool RegexRule::matchesPosition(int position, string character)
+  {
+    if (character.size() == 0 || utf8::find_invalid(character.begin(), character.end()) != character.end())
+      return false;
+
+    string::iterator utf_iterator = character.begin();
+    int cp = utf8::next(utf_iterator, character.end());
+
+    // Only a single character can fill a position
+    if (utf_iterator != character.end())
+      return false;
+
+    return matchesPosition(position, cp);
+  }
+
+  bool RegexRule::matchesPosition(int position, int codepoint)
+  {
+    if (!this->valid || position < 0 || position >= (int) position_classes.size())
       return false;
 
+    if (position_compiled[position])
+      return position_classes[position].contains(codepoint);
+
+    string character = utf8chr(codepoint);
+
     OnigRegion *region = onig_region_new();
-    unsigned char *start, *end;
-    UChar* cstr_text = (UChar* )text.c_str();
-    end   = cstr_text + strlen((char* )cstr_text);
-    start = cstr_text;
-    
-    int match = onig_match(onig_regex, cstr_text, end, start, region, ONIG_OPTION_NONE);
-    
+    UChar* cstr_text = (UChar* )character.c_str();
+    UChar* end = cstr_text + character.size();
+
+    int match = onig_match(position_regexes[position], cstr_text, end, cstr_text, region, ONIG_OPTION_NONE);
+
     onig_region_free(region, 1);
-    
-    return match == text.length();
+
+    return match == (int) character.size();
   }
 
   string RegexRule::filterSkips(string text)
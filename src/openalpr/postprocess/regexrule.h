@@ -30,6 +30,32 @@
 
 namespace alpr
 {
+  // The set of characters allowed at one position of a pattern.  ASCII characters are looked up in
+  // a bitset, others are checked against the explicit ranges and the Unicode alpha/digit classes.
+  class CharacterClass
+  {
+    public:
+      CharacterClass();
+
+      // Compiles the regex for a single position (\p{Alpha}, \p{Digit}, ".", [...] or a literal).
+      // Returns false for any other syntax, which has to be matched with the regex instead.
+      bool compile(std::string position_regex);
+
+      bool contains(int codepoint) const;
+
+    private:
+      unsigned int ascii[4];
+      bool any;
+      bool alpha;
+      bool digit;
+      bool negated;
+
+      // Inclusive ranges of non-ASCII codepoints
+      std::vector<std::pair<int, int> > ranges;
+
+      void addRange(int first, int last);
+  };
+
   class RegexRule
   {
     public:
@@ -39,11 +65,24 @@ namespace alpr
       bool match(std::string text);
       std::string filterSkips(std::string text);
 
+      // Number of characters in the pattern
+      int getLength();
+
+      // True if the single character can appear at the position in the pattern
+      bool matchesPosition(int position, std::string character);
+      bool matchesPosition(int position, int codepoint);
+
     private:
       bool valid;
       
       int numchars;
-      regex_t* onig_regex;
+
+      // One regex per character position, each matching a single character
+      std::vector<regex_t*> position_regexes;
+
+      // The compiled form of each position regex.  Positions that could not be compiled fall back to the regex.
+      std::vector<CharacterClass> position_classes;
+      std::vector<bool> position_compiled;
       std::string original;
       std::string regex;
       std::string region;
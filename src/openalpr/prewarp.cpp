@@ -28,6 +28,12 @@ using namespace cv;
 namespace alpr
 {
 
+  // Margin warped around each region of interest, on top of a quarter of its size
+  const int ROI_WARP_MARGIN_PX = 16;
+
+  // Above this fraction of the image, the whole image is warped rather than the regions of interest
+  const double MAX_ROI_WARP_AREA_PERCENT = 0.5;
+
   PreWarp::PreWarp(Config* config) {
     this->config = config;
     
@@ -104,10 +110,80 @@ namespace alpr
         cout << "prewarp skipped due to missing prewarp config" << endl;
       return image;
     }
+
+    updateTransform(image.size());
+
+    Mat warped_image;
+
+    remap(image, warped_image, remapXY, remapFraction, config->prewarpInterpolation);
+
     
-      
-    float width_ratio = w / ((float)image.cols);
-    float height_ratio = h / ((float)image.rows);
+    if (this->config->debugPrewarp && this->config->debugShowImages)
+    {
+      imshow("Prewarp", warped_image);
+    }
+    return warped_image;
+  }
+
+  cv::Mat PreWarp::warpRegionsOfInterest(Mat image, vector<Rect> regionsOfInterest, vector<Rect>& warpedRegionsOfInterest) {
+    if (!this->valid)
+    {
+      warpedRegionsOfInterest = regionsOfInterest;
+      return warpImage(image);
+    }
+
+    updateTransform(image.size());
+    warpedRegionsOfInterest = projectRects(regionsOfInterest, image.cols, image.rows, false);
+
+    // Later stages may look slightly outside a detected plate, so warp a margin around each region
+    vector<Rect> warpAreas;
+    double totalArea = 0;
+    for (unsigned int i = 0; i < warpedRegionsOfInterest.size(); i++)
+    {
+      Rect roi = warpedRegionsOfInterest[i];
+      Rect warpArea = expandRect(roi, roi.width / 4 + ROI_WARP_MARGIN_PX, roi.height / 4 + ROI_WARP_MARGIN_PX, image.cols, image.rows);
+      warpAreas.push_back(warpArea);
+      totalArea += warpArea.area();
+    }
+
+    // Not worth it when the regions cover most of the image
+    if (totalArea > ((double) image.cols) * image.rows * MAX_ROI_WARP_AREA_PERCENT)
+      return warpImage(image);
+
+    Mat warped_image = Mat::zeros(image.size(), image.type());
+
+    for (unsigned int i = 0; i < warpAreas.size(); i++)
+    {
+      if (warpAreas[i].area() == 0)
+        continue;
+
+      Mat warpedArea = warped_image(warpAreas[i]);
+      Mat areaFraction;
+      if (!remapFraction.empty())
+        areaFraction = remapFraction(warpAreas[i]);
+
+      remap(image, warpedArea, remapXY(warpAreas[i]), areaFraction, config->prewarpInterpolation);
+    }
+
+    if (this->config->debugPrewarp)
+      cout << "Prewarp warped " << warpAreas.size() << " regions of interest, " << (100.0 * totalArea / (image.cols * image.rows)) << "% of the image" << endl;
+
+    if (this->config->debugPrewarp && this->config->debugShowImages)
+    {
+      imshow("Prewarp", warped_image);
+    }
+    return warped_image;
+  }
+
+  void PreWarp::updateTransform(Size imageSize) {
+    if (imageSize == transformSize && !transform.empty())
+      return;
+
+    timespec startTime;
+    getTimeMonotonic(&startTime);
+
+    float width_ratio = w / ((float)imageSize.width);
+    float height_ratio = h / ((float)imageSize.height);
 
     float rx = rotationx * width_ratio;
     float ry = rotationy * width_ratio;
@@ -115,19 +191,39 @@ namespace alpr
     float py = panY / height_ratio;
 
 
-    transform = findTransform(image.cols, image.rows, rx, ry, rotationz, px, py, stretchX, dist);
-    
-    
-    Mat warped_image;
-  
-    warpPerspective(image, warped_image, transform, image.size(), INTER_CUBIC | WARP_INVERSE_MAP);
+    transform = findTransform(imageSize.width, imageSize.height, rx, ry, rotationz, px, py, stretchX, dist);
+    inverseTransform = transform.inv();
+    transformSize = imageSize;
 
-    
-    if (this->config->debugPrewarp && this->config->debugShowImages)
+    // The transform maps each warped pixel to its source position (same as WARP_INVERSE_MAP)
+    Mat mapX(imageSize, CV_32FC1);
+    Mat mapY(imageSize, CV_32FC1);
+    const double* m = transform.ptr<double>(0);
+    for (int y = 0; y < imageSize.height; y++)
     {
-      imshow("Prewarp", warped_image);
+      float* mapXRow = mapX.ptr<float>(y);
+      float* mapYRow = mapY.ptr<float>(y);
+      for (int x = 0; x < imageSize.width; x++)
+      {
+        double srcX = m[0] * x + m[1] * y + m[2];
+        double srcY = m[3] * x + m[4] * y + m[5];
+        double srcW = m[6] * x + m[7] * y + m[8];
+        srcW = srcW != 0 ? 1.0 / srcW : 0;
+
+        mapXRow[x] = (float) (srcX * srcW);
+        mapYRow[x] = (float) (srcY * srcW);
+      }
+    }
+
+    bool nearest = config->prewarpInterpolation == PREWARP_INTERPOLATION_NEAREST;
+    convertMaps(mapX, mapY, remapXY, remapFraction, CV_16SC2, nearest);
+
+    if (this->config->debugPrewarp)
+    {
+      timespec endTime;
+      getTimeMonotonic(&endTime);
+      cout << "Prewarp remap table built for " << imageSize.width << "x" << imageSize.height << " in " << diffclock(startTime, endTime) << "ms" << endl;
     }
-    return warped_image;
   }
 
   // Projects a "region of interest" into the new space
@@ -167,7 +263,7 @@ namespace alpr
     vector<Point2f> output;
     
     if (!inverse)
-      perspectiveTransform(points, output, transform.inv());
+      perspectiveTransform(points, output, inverseTransform);
     else
       perspectiveTransform(points, output, transform);
     
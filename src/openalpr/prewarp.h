@@ -35,6 +35,11 @@ namespace alpr
     virtual ~PreWarp();
 
     cv::Mat warpImage(cv::Mat image);
+
+    // Warps the image and projects the regions of interest into the warped image.  When the projected
+    // regions cover a small part of the image, only they (plus a margin) are warped and the rest of the
+    // warped image is left black.  Coordinates in the warped image are the same either way.
+    cv::Mat warpRegionsOfInterest(cv::Mat image, std::vector<cv::Rect> regionsOfInterest, std::vector<cv::Rect>& warpedRegionsOfInterest);
     std::vector<cv::Point2f> projectPoints(std::vector<cv::Point2f> points, bool inverse);
     std::vector<cv::Rect> projectRects(std::vector<cv::Rect> rects, int maxWidth, int maxHeight, bool inverse);
     void projectPlateRegions(std::vector<PlateRegion>& plateRegions, int maxWidth, int maxHeight, bool inverse);
@@ -43,7 +48,16 @@ namespace alpr
     
   private:
     Config* config;
+
+    // The transform for the last image size warped, its inverse, and the matching fixed point remap table.
+    // The camera geometry doesn't change, so these are only rebuilt when the image size does.
+    cv::Size transformSize;
     cv::Mat transform;
+    cv::Mat inverseTransform;
+    cv::Mat remapXY;
+    cv::Mat remapFraction;
+
+    void updateTransform(cv::Size imageSize);
     
     float w, h, rotationx, rotationy, rotationz, stretchX, dist, panX, panY;
     
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scratcharena.h"
+
+using namespace cv;
+using namespace std;
+
+namespace alpr
+{
+
+  ScratchArena::ScratchArena()
+  {
+    this->allocationCount = 0;
+  }
+
+  ScratchArena::~ScratchArena()
+  {
+    release();
+  }
+
+  Mat& ScratchArena::get(int slot, Size size, int type)
+  {
+    if (slot >= (int) buffers.size())
+      buffers.resize(slot + 1);
+
+    Mat& buffer = buffers[slot];
+    if (buffer.empty() || buffer.size() != size || buffer.type() != type)
+    {
+      buffer.create(size, type);
+      allocationCount++;
+    }
+
+    return buffer;
+  }
+
+  Mat& ScratchArena::zeros(int slot, Size size, int type)
+  {
+    Mat& buffer = get(slot, size, type);
+    buffer.setTo(Scalar::all(0));
+
+    return buffer;
+  }
+
+  int ScratchArena::getAllocationCount()
+  {
+    return allocationCount;
+  }
+
+  void ScratchArena::resetAllocationCount()
+  {
+    allocationCount = 0;
+  }
+
+  void ScratchArena::release()
+  {
+    for (unsigned int i = 0; i < buffers.size(); i++)
+      buffers[i].release();
+    buffers.clear();
+  }
+
+}
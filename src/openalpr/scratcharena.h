@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_SCRATCHARENA_H
+#define OPENALPR_SCRATCHARENA_H
+
+#include <deque>
+
+#include "opencv2/core/core.hpp"
+
+namespace alpr
+{
+
+  // A set of reusable cv::Mat buffers, addressed by slot number.
+  // A buffer is only reallocated when the requested size or type changes, so a
+  // stage that asks for the same buffers repeatedly only allocates them once.
+  // Callers must not hold on to a buffer after the same slot is requested again.
+  class ScratchArena
+  {
+
+    public:
+      ScratchArena();
+      virtual ~ScratchArena();
+
+      // Returns the buffer for the slot.  The contents are undefined.
+      cv::Mat& get(int slot, cv::Size size, int type);
+
+      // Returns the buffer for the slot, cleared to zero.
+      cv::Mat& zeros(int slot, cv::Size size, int type);
+
+      // Number of buffer (re)allocations since construction or the last reset
+      int getAllocationCount();
+      void resetAllocationCount();
+
+      void release();
+
+    private:
+      // A deque so that adding slots never moves the buffers already handed out
+      std::deque<cv::Mat> buffers;
+      int allocationCount;
+  };
+
+}
+
+#endif // OPENALPR_SCRATCHARENA_H
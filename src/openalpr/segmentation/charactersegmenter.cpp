@@ -27,6 +27,35 @@ using namespace std;
 namespace alpr
 {
 
+  // Height of the foreground pixels within the box.  This is the same as the bounding box height of the
+  // contours findContours() would find in the box, which treats the outermost image pixels as background.
+  static int getForegroundHeight(const Mat& img, Rect box)
+  {
+    box = box & Rect(1, 1, img.cols - 2, img.rows - 2);
+
+    int topRow = -1;
+    int bottomRow = -1;
+    for (int row = box.y; row < box.y + box.height; row++)
+    {
+      const uchar* pixels = img.ptr<uchar>(row) + box.x;
+      for (int col = 0; col < box.width; col++)
+      {
+        if (pixels[col] != 0)
+        {
+          if (topRow < 0)
+            topRow = row;
+          bottomRow = row;
+          break;
+        }
+      }
+    }
+
+    if (topRow < 0)
+      return 0;
+
+    return bottomRow - topRow + 1;
+  }
+
   CharacterSegmenter::CharacterSegmenter(PipelineData* pipeline_data)
   {
     this->pipeline_data = pipeline_data;
@@ -44,8 +73,8 @@ namespace alpr
 
     if (pipeline_data->plate_inverted)
       bitwise_not(pipeline_data->crop_gray, pipeline_data->crop_gray);
-    pipeline_data->clearThresholds();
-    pipeline_data->thresholds = produceThresholds(pipeline_data->crop_gray, config);
+    pipeline_data->prepareThresholds(PipelineData::SCRATCH_SEGMENTATION_THRESHOLDS);
+    produceThresholds(pipeline_data->crop_gray, config, pipeline_data->thresholds);
 
     // TODO: Perhaps a bilateral filter would be better here.
     medianBlur(pipeline_data->crop_gray, pipeline_data->crop_gray, 3);
@@ -73,7 +102,11 @@ namespace alpr
       float height_to_width_ratio = pipeline_data->config->charHeightMM / pipeline_data->config->charWidthMM;
       float avgCharWidth = avgCharHeight / height_to_width_ratio;
 
-      removeSmallContours(pipeline_data->thresholds, avgCharHeight, pipeline_data->textLines[lineidx]);
+      // The same text line mask is used for removing small contours and for each histogram
+      Mat& textLineMask = pipeline_data->scratch.zeros(SCRATCH_LINE_MASK, pipeline_data->thresholds[0].size(), CV_8U);
+      fillConvexPoly(textLineMask, pipeline_data->textLines[lineidx].linePolygon.data(), pipeline_data->textLines[lineidx].linePolygon.size(), Scalar(255,255,255));
+
+      removeSmallContours(pipeline_data->thresholds, avgCharHeight, textLineMask);
 
       // Do the histogram analysis to figure out char regions
 
@@ -85,11 +118,7 @@ namespace alpr
       vector<Rect> lineBoxes;
       for (unsigned int i = 0; i < pipeline_data->thresholds.size(); i++)
       {
-        Mat histogramMask = Mat::zeros(pipeline_data->thresholds[i].size(), CV_8U);
-
-        fillConvexPoly(histogramMask, pipeline_data->textLines[lineidx].linePolygon.data(), pipeline_data->textLines[lineidx].linePolygon.size(), Scalar(255,255,255));
-
-        VerticalHistogram vertHistogram(pipeline_data->thresholds[i], histogramMask);
+        VerticalHistogram vertHistogram(pipeline_data->thresholds[i], textLineMask, this->config->debugCharSegmenter);
 
         if (this->config->debugCharSegmenter)
         {
@@ -117,7 +146,6 @@ namespace alpr
 
         for (unsigned int z = 0; z < charBoxes.size(); z++)
           lineBoxes.push_back(charBoxes[z]);
-        //drawAndWait(&histogramMask);
       }
 
       float medianCharWidth = avgCharWidth;
@@ -204,7 +232,7 @@ namespace alpr
 
   // Given a histogram and the horizontal line boundaries, respond with an array of boxes where the characters are
   // Scores the histogram quality as well based on num chars, char volume, and even separation
-  vector<Rect> CharacterSegmenter::getHistogramBoxes(VerticalHistogram histogram, float avgCharWidth, float avgCharHeight, float* score)
+  vector<Rect> CharacterSegmenter::getHistogramBoxes(const VerticalHistogram& histogram, float avgCharWidth, float avgCharHeight, float* score)
   {
     float MIN_HISTOGRAM_HEIGHT = avgCharHeight * config->segmentationMinCharHeightPercent;
 
@@ -215,7 +243,7 @@ namespace alpr
     int pxLeniency = 2;
 
     vector<Rect> charBoxes;
-    vector<Rect> allBoxes = get1DHits(histogram.histoImg, pxLeniency);
+    vector<Rect> allBoxes = get1DHits(histogram, pxLeniency);
 
     for (unsigned int i = 0; i < allBoxes.size(); i++)
     {
@@ -258,14 +286,14 @@ namespace alpr
     return charBoxes;
   }
 
-  vector<Rect> CharacterSegmenter::getBestCharBoxes(Mat img, vector<Rect> charBoxes, float avgCharWidth)
+  vector<Rect> CharacterSegmenter::getBestCharBoxes(const Mat& img, const vector<Rect>& charBoxes, float avgCharWidth)
   {
     float MAX_SEGMENT_WIDTH = avgCharWidth * 1.65;
 
     // This histogram is based on how many char boxes (from ALL of the many thresholded images) are covering each column
     // Makes a sort of histogram from all the previous char boxes.  Figures out the best fit from that.
 
-    Mat histoImg = Mat::zeros(Size(img.cols, img.rows), CV_8U);
+    Mat& histoImg = pipeline_data->scratch.zeros(SCRATCH_WORK, Size(img.cols, img.rows), CV_8U);
 
     int columnCount;
 
@@ -284,7 +312,8 @@ namespace alpr
         histoImg.at<uchar>(histoImg.rows -  columnCount, col) = 255;
     }
 
-    VerticalHistogram histogram(histoImg, Mat::ones(histoImg.size(), CV_8U));
+    // The image doubles as its own mask, every pixel counts
+    VerticalHistogram histogram(histoImg, histoImg);
 
     // Go through each row in the histoImg and score it.  Try to find the single line that gives me the most right-sized character regions (based on avgCharWidth)
 
@@ -295,7 +324,7 @@ namespace alpr
     for (int row = 0; row < histoImg.rows; row++)
     {
       vector<Rect> validBoxes;
-      vector<Rect> allBoxes = get1DHits(histoImg, row);
+      vector<Rect> allBoxes = get1DHits(histogram, row);
 
       if (this->config->debugCharSegmenter)
         cout << "All Boxes size " << allBoxes.size() << endl;
@@ -358,8 +387,9 @@ namespace alpr
 
     if (this->config->debugCharSegmenter)
     {
-      cvtColor(histoImg, histoImg, CV_GRAY2BGR);
-      line(histoImg, Point(0, histoImg.rows - 1 - bestRowIndex), Point(histoImg.cols, histoImg.rows - 1 - bestRowIndex), Scalar(0, 255, 0));
+      Mat histoDebugImg;
+      cvtColor(histoImg, histoDebugImg, CV_GRAY2BGR);
+      line(histoDebugImg, Point(0, histoDebugImg.rows - 1 - bestRowIndex), Point(histoDebugImg.cols, histoDebugImg.rows - 1 - bestRowIndex), Scalar(0, 255, 0));
 
       Mat imgBestBoxes(img.size(), img.type());
       img.copyTo(imgBestBoxes);
@@ -367,22 +397,24 @@ namespace alpr
       for (unsigned int i = 0; i < bestBoxes.size(); i++)
         rectangle(imgBestBoxes, bestBoxes[i], Scalar(0, 255, 0));
 
-      this->imgDbgGeneral.push_back(addLabel(histoImg, "All Histograms"));
+      this->imgDbgGeneral.push_back(addLabel(histoDebugImg, "All Histograms"));
       this->imgDbgGeneral.push_back(addLabel(imgBestBoxes, "Best Boxes"));
     }
 
     return bestBoxes;
   }
 
-  vector<Rect> CharacterSegmenter::get1DHits(Mat img, int yOffset)
+  // Returns the horizontal runs of columns whose histogram height is above yOffset
+  vector<Rect> CharacterSegmenter::get1DHits(const VerticalHistogram& histogram, int yOffset)
   {
     vector<Rect> hits;
 
     bool onSegment = false;
     int curSegmentLength = 0;
-    for (int col = 0; col < img.cols; col++)
+    int width = histogram.getWidth();
+    for (int col = 0; col < width; col++)
     {
-      bool isOn = img.at<uchar>(img.rows - 1 - yOffset, col);
+      bool isOn = histogram.getHeightAt(col) > yOffset;
       if (isOn)
       {
         // We're on a segment.  Increment the length
@@ -390,7 +422,7 @@ namespace alpr
         curSegmentLength++;
       }
 
-      if (onSegment && (isOn == false || (col == img.cols - 1)))
+      if (onSegment && (isOn == false || (col == width - 1)))
       {
         // A segment just ended or we're at the very end of the row and we're on a segment
         Point topLeft = Point(col - curSegmentLength, top.getPointAt(col - curSegmentLength) - 1);
@@ -405,19 +437,16 @@ namespace alpr
     return hits;
   }
 
-  void CharacterSegmenter::removeSmallContours(vector<Mat> thresholds, float avgCharHeight,  TextLine textLine)
+  void CharacterSegmenter::removeSmallContours(vector<Mat>& thresholds, float avgCharHeight, const Mat& textLineMask)
   {
     //const float MIN_CHAR_AREA = 0.02 * avgCharWidth * avgCharHeight;	// To clear out the tiny specks
     const float MIN_CONTOUR_HEIGHT = 0.3 * avgCharHeight;
 
-    Mat textLineMask = Mat::zeros(thresholds[0].size(), CV_8U);
-    fillConvexPoly(textLineMask, textLine.linePolygon.data(), textLine.linePolygon.size(), Scalar(255,255,255));
-
     for (unsigned int i = 0; i < thresholds.size(); i++)
     {
       vector<vector<Point> > contours;
       vector<Vec4i> hierarchy;
-      Mat thresholdsCopy = Mat::zeros(thresholds[i].size(), thresholds[i].type());
+      Mat& thresholdsCopy = pipeline_data->scratch.zeros(SCRATCH_WORK, thresholds[i].size(), thresholds[i].type());
 
       thresholds[i].copyTo(thresholdsCopy, textLineMask);
       findContours(thresholdsCopy, contours, hierarchy, CV_RETR_TREE, CV_CHAIN_APPROX_SIMPLE);
@@ -438,7 +467,7 @@ namespace alpr
     }
   }
 
-  vector<Rect> CharacterSegmenter::combineCloseBoxes( vector<Rect> charBoxes, float biggestCharWidth)
+  vector<Rect> CharacterSegmenter::combineCloseBoxes(const vector<Rect>& charBoxes, float biggestCharWidth)
   {
     vector<Rect> newCharBoxes;
 
@@ -482,21 +511,21 @@ namespace alpr
     return newCharBoxes;
   }
 
-  void CharacterSegmenter::cleanCharRegions(vector<Mat> thresholds, vector<Rect> charRegions)
+  void CharacterSegmenter::cleanCharRegions(vector<Mat>& thresholds, const vector<Rect>& charRegions)
   {
     const float MIN_SPECKLE_HEIGHT_PERCENT = 0.13;
     const float MIN_SPECKLE_WIDTH_PX = 3;
     const float MIN_CONTOUR_AREA_PERCENT = 0.1;
     const float MIN_CONTOUR_HEIGHT_PERCENT = config->segmentationMinCharHeightPercent;
 
-    Mat mask = getCharBoxMask(thresholds[0], charRegions);
+    Mat& mask = getCharBoxMask(thresholds[0], charRegions);
 
     for (unsigned int i = 0; i < thresholds.size(); i++)
     {
       bitwise_and(thresholds[i], mask, thresholds[i]);
       vector<vector<Point> > contours;
 
-      Mat tempImg(thresholds[i].size(), thresholds[i].type());
+      Mat& tempImg = pipeline_data->scratch.get(SCRATCH_WORK, thresholds[i].size(), thresholds[i].type());
       thresholds[i].copyTo(tempImg);
 
       //Mat element = getStructuringElement( 1,
@@ -595,7 +624,7 @@ namespace alpr
     }
   }
 
-  void CharacterSegmenter::cleanBasedOnColor(vector<Mat> thresholds, Mat colorMask, vector<Rect> charRegions)
+  void CharacterSegmenter::cleanBasedOnColor(vector<Mat>& thresholds, const Mat& colorMask, const vector<Rect>& charRegions)
   {
     // If I knock out x% of the contour area from this thing (after applying the color filter)
     // Consider it a bad news bear.  REmove the whole area.
@@ -605,14 +634,14 @@ namespace alpr
     {
       for (unsigned int j = 0; j < charRegions.size(); j++)
       {
-        Mat boxChar = Mat::zeros(thresholds[i].size(), CV_8U);
+        Mat& boxChar = pipeline_data->scratch.zeros(SCRATCH_WORK, thresholds[i].size(), CV_8U);
         rectangle(boxChar, charRegions[j], Scalar(255,255,255), CV_FILLED);
 
         bitwise_and(thresholds[i], boxChar, boxChar);
 
         float meanBefore = mean(boxChar, boxChar)[0];
 
-        Mat thresholdCopy(thresholds[i].size(), CV_8U);
+        Mat& thresholdCopy = pipeline_data->scratch.get(SCRATCH_WORK2, thresholds[i].size(), CV_8U);
         bitwise_and(colorMask, boxChar, thresholdCopy);
 
         float meanAfter = mean(thresholdCopy, boxChar)[0];
@@ -648,7 +677,7 @@ namespace alpr
   }
 
 
-  vector<Rect> CharacterSegmenter::filterMostlyEmptyBoxes(vector<Mat> thresholds, const vector<Rect> charRegions)
+  vector<Rect> CharacterSegmenter::filterMostlyEmptyBoxes(vector<Mat>& thresholds, const vector<Rect>& charRegions)
   {
     // Of the n thresholded images, if box 3 (for example) is empty in half (for example) of the thresholded images,
     // clear all data for every box #3.
@@ -656,8 +685,6 @@ namespace alpr
     //const float MIN_AREA_PERCENT = 0.1;
     const float MIN_CONTOUR_HEIGHT_PERCENT = config->segmentationMinCharHeightPercent;
 
-    Mat mask = getCharBoxMask(thresholds[0], charRegions);
-
     vector<int> boxScores(charRegions.size());
 
     for (unsigned int i = 0; i < charRegions.size(); i++)
@@ -669,28 +696,7 @@ namespace alpr
       {
         //float minArea = charRegions[j].area() * MIN_AREA_PERCENT;
 
-        Mat tempImg = Mat::zeros(thresholds[i].size(), thresholds[i].type());
-        rectangle(tempImg, charRegions[j], Scalar(255,255,255), CV_FILLED);
-        bitwise_and(thresholds[i], tempImg, tempImg);
-
-        vector<vector<Point> > contours;
-        findContours(tempImg, contours, RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE);
-
-        vector<Point> allPointsInBox;
-        for (unsigned int c = 0; c < contours.size(); c++)
-        {
-          if (contours[c].size() == 0)
-            continue;
-
-          for (unsigned int z = 0; z < contours[c].size(); z++)
-            allPointsInBox.push_back(contours[c][z]);
-        }
-
-        float height = 0;
-        if (allPointsInBox.size() > 0)
-        {
-          height = boundingRect(allPointsInBox).height;
-        }
+        float height = getForegroundHeight(thresholds[i], charRegions[j]);
 
         if (height >= ((float) charRegions[j].height * MIN_CONTOUR_HEIGHT_PERCENT))
         {
@@ -745,7 +751,7 @@ namespace alpr
     return newCharRegions;
   }
 
-  void CharacterSegmenter::filterEdgeBoxes(vector<Mat> thresholds, const vector<Rect> charRegions, float avgCharWidth, float avgCharHeight)
+  void CharacterSegmenter::filterEdgeBoxes(vector<Mat>& thresholds, const vector<Rect>& charRegions, float avgCharWidth, float avgCharHeight)
   {
     const float MIN_ANGLE_FOR_ROTATION = 0.4;
     int MIN_CONNECTED_EDGE_PIXELS = (avgCharHeight * 1.5);
@@ -786,12 +792,12 @@ namespace alpr
       if (abs(top.angle) > MIN_ANGLE_FOR_ROTATION)
       {
         // Rotate image:
-        rotated = Mat(thresholds[i].size(), thresholds[i].type());
-        Mat rot_mat( 2, 3, CV_32FC1 );
+        Mat& rotatedBuffer = pipeline_data->scratch.get(SCRATCH_WORK, thresholds[i].size(), thresholds[i].type());
         Point center = Point( thresholds[i].cols/2, thresholds[i].rows/2 );
 
-        rot_mat = getRotationMatrix2D( center, top.angle, 1.0 );
-        warpAffine( thresholds[i], rotated, rot_mat, thresholds[i].size() );
+        Mat rot_mat = getRotationMatrix2D( center, top.angle, 1.0 );
+        warpAffine( thresholds[i], rotatedBuffer, rot_mat, thresholds[i].size() );
+        rotated = rotatedBuffer;
       }
       else
       {
@@ -851,16 +857,15 @@ namespace alpr
 
     if (leftEdge != 0 || rightEdge != thresholds[0].cols)
     {
-      Mat mask = Mat::zeros(thresholds[0].size(), CV_8U);
+      Mat& mask = pipeline_data->scratch.zeros(SCRATCH_EDGE_MASK, thresholds[0].size(), CV_8U);
       rectangle(mask, Point(leftEdge, 0), Point(rightEdge, thresholds[0].rows), Scalar(255,255,255), -1);
 
       if (abs(top.angle) > MIN_ANGLE_FOR_ROTATION)
       {
         // Rotate mask:
-        Mat rot_mat( 2, 3, CV_32FC1 );
         Point center = Point( mask.cols/2, mask.rows/2 );
 
-        rot_mat = getRotationMatrix2D( center, top.angle * -1, 1.0 );
+        Mat rot_mat = getRotationMatrix2D( center, top.angle * -1, 1.0 );
         warpAffine( mask, mask, rot_mat, mask.size() );
       }
 
@@ -905,7 +910,7 @@ namespace alpr
 
   }
 
-  int CharacterSegmenter::getLongestBlobLengthBetweenLines(Mat img, int col)
+  int CharacterSegmenter::getLongestBlobLengthBetweenLines(const Mat& img, int col)
   {
     int longestBlobLength = 0;
 
@@ -1013,9 +1018,10 @@ namespace alpr
     return -1;
   }
 
-  Mat CharacterSegmenter::getCharBoxMask(Mat img_threshold, vector<Rect> charBoxes)
+  // The mask lives in the scratch arena and is overwritten by the next call
+  Mat& CharacterSegmenter::getCharBoxMask(const Mat& img_threshold, const vector<Rect>& charBoxes)
   {
-    Mat mask = Mat::zeros(img_threshold.size(), CV_8U);
+    Mat& mask = pipeline_data->scratch.zeros(SCRATCH_CHARBOX_MASK, img_threshold.size(), CV_8U);
     for (unsigned int i = 0; i < charBoxes.size(); i++)
       rectangle(mask, charBoxes[i], Scalar(255, 255, 255), -1);
 
@@ -62,23 +62,33 @@ namespace alpr
       std::vector<cv::Mat> imgDbgGeneral;
       std::vector<cv::Mat> imgDbgCleanStages;
 
-      cv::Mat getCharBoxMask(cv::Mat img_threshold, std::vector<cv::Rect> charBoxes);
+      // Slots in the pipeline scratch arena used by the segmenter
+      enum ScratchSlot
+      {
+        SCRATCH_LINE_MASK,
+        SCRATCH_CHARBOX_MASK,
+        SCRATCH_EDGE_MASK,
+        SCRATCH_WORK,
+        SCRATCH_WORK2
+      };
 
-      void removeSmallContours(std::vector<cv::Mat> thresholds, float avgCharHeight, TextLine textLine);
+      cv::Mat& getCharBoxMask(const cv::Mat& img_threshold, const std::vector<cv::Rect>& charBoxes);
 
-      std::vector<cv::Rect> getHistogramBoxes(VerticalHistogram histogram, float avgCharWidth, float avgCharHeight, float* score);
-      std::vector<cv::Rect> getBestCharBoxes(cv::Mat img, std::vector<cv::Rect> charBoxes, float avgCharWidth);
-      std::vector<cv::Rect> combineCloseBoxes( std::vector<cv::Rect> charBoxes, float avgCharWidth);
+      void removeSmallContours(std::vector<cv::Mat>& thresholds, float avgCharHeight, const cv::Mat& textLineMask);
 
-      std::vector<cv::Rect> get1DHits(cv::Mat img, int yOffset);
+      std::vector<cv::Rect> getHistogramBoxes(const VerticalHistogram& histogram, float avgCharWidth, float avgCharHeight, float* score);
+      std::vector<cv::Rect> getBestCharBoxes(const cv::Mat& img, const std::vector<cv::Rect>& charBoxes, float avgCharWidth);
+      std::vector<cv::Rect> combineCloseBoxes(const std::vector<cv::Rect>& charBoxes, float avgCharWidth);
 
-      void cleanCharRegions(std::vector<cv::Mat> thresholds, std::vector<cv::Rect> charRegions);
-      void cleanBasedOnColor(std::vector<cv::Mat> thresholds, cv::Mat colorMask, std::vector<cv::Rect> charRegions);
-      void cleanMostlyFullBoxes(std::vector<cv::Mat> thresholds, const std::vector<cv::Rect> charRegions);
-      std::vector<cv::Rect> filterMostlyEmptyBoxes(std::vector<cv::Mat> thresholds, const  std::vector<cv::Rect> charRegions);
-      void filterEdgeBoxes(std::vector<cv::Mat> thresholds, const std::vector<cv::Rect> charRegions, float avgCharWidth, float avgCharHeight);
+      std::vector<cv::Rect> get1DHits(const VerticalHistogram& histogram, int yOffset);
 
-      int getLongestBlobLengthBetweenLines(cv::Mat img, int col);
+      void cleanCharRegions(std::vector<cv::Mat>& thresholds, const std::vector<cv::Rect>& charRegions);
+      void cleanBasedOnColor(std::vector<cv::Mat>& thresholds, const cv::Mat& colorMask, const std::vector<cv::Rect>& charRegions);
+      void cleanMostlyFullBoxes(std::vector<cv::Mat>& thresholds, const std::vector<cv::Rect>& charRegions);
+      std::vector<cv::Rect> filterMostlyEmptyBoxes(std::vector<cv::Mat>& thresholds, const std::vector<cv::Rect>& charRegions);
+      void filterEdgeBoxes(std::vector<cv::Mat>& thresholds, const std::vector<cv::Rect>& charRegions, float avgCharWidth, float avgCharHeight);
+
+      int getLongestBlobLengthBetweenLines(const cv::Mat& img, int col);
 
       int isSkinnyLineInsideBox(cv::Mat threshold, cv::Rect box, std::vector<std::vector<cv::Point> > contours, std::vector<cv::Vec4i> hierarchy, float avgCharWidth, float avgCharHeight);
 
@@ -25,9 +25,12 @@ using namespace std;
 namespace alpr
 {
 
-  VerticalHistogram::VerticalHistogram(Mat inputImage, Mat mask)
+  VerticalHistogram::VerticalHistogram(const Mat& inputImage, const Mat& mask, bool createHistogramImage)
   {
     analyzeImage(inputImage, mask);
+
+    if (createHistogramImage)
+      drawHistogramImage();
   }
 
   VerticalHistogram::~VerticalHistogram()
@@ -36,40 +39,37 @@ namespace alpr
     colHeights.clear();
   }
 
-  void VerticalHistogram::analyzeImage(Mat inputImage, Mat mask)
+  void VerticalHistogram::analyzeImage(const Mat& inputImage, const Mat& mask)
   {
-    
-    vector<double> data;
-    
+    imageHeight = inputImage.rows;
     highestPeak = 0;
     lowestValley = inputImage.rows;
 
-    histoImg = Mat::zeros(inputImage.size(), CV_8U);
+    colHeights.assign(inputImage.cols, 0);
 
-    int columnCount;
+    if (inputImage.cols == 0)
+      return;
 
-    for (int col = 0; col < inputImage.cols; col++)
+    // Walk the image row by row so that the image and the mask are both read sequentially.
+    // The inner loop is branch-free, which lets the compiler vectorize it.
+    int* heights = &colHeights[0];
+    for (int row = 0; row < inputImage.rows; row++)
     {
-      columnCount = 0;
-
-      for (int row = 0; row < inputImage.rows; row++)
-      {
-        if (inputImage.at<uchar>(row, col) > 0 && mask.at<uchar>(row, col) > 0)
-          columnCount++;
-      }
-
-      this->colHeights.push_back(columnCount);
+      const uchar* imgRow = inputImage.ptr<uchar>(row);
+      const uchar* maskRow = mask.ptr<uchar>(row);
 
-      if (columnCount < lowestValley)
-        lowestValley = columnCount;
-      if (columnCount > highestPeak)
-        highestPeak = columnCount;
+      for (int col = 0; col < inputImage.cols; col++)
+        heights[col] += (imgRow[col] != 0) & (maskRow[col] != 0);
+    }
 
-      data.push_back(columnCount);
-      for (; columnCount > 0; columnCount--)
-        histoImg.at<uchar>(inputImage.rows - columnCount, col) = 255;
+    for (int col = 0; col < inputImage.cols; col++)
+    {
+      if (heights[col] < lowestValley)
+        lowestValley = heights[col];
+      if (heights[col] > highestPeak)
+        highestPeak = heights[col];
     }
-    
+
 //    int         MAX_PEAK=200;
 //    int         emi_peaks[MAX_PEAK];
 //    int         absorp_peaks[MAX_PEAK];
@@ -78,6 +78,7 @@ namespace alpr
 //    double      delta = highestPeak * (1.0 / 3.0);
 //    int         emission_first = 0;
 //    
+//    vector<double> data(colHeights.begin(), colHeights.end());
 //    detect_peak(data.data(), data.size(), emi_peaks, &emi_count, MAX_PEAK,
 //            absorp_peaks, &absorp_count, MAX_PEAK,
 //            delta, emission_first);
@@ -101,9 +102,24 @@ namespace alpr
 //    drawAndWait(&colorDebugImg);
   }
 
-  int VerticalHistogram::getLocalMinimum(int leftX, int rightX)
+  void VerticalHistogram::drawHistogramImage()
   {
-    int minimum = histoImg.rows + 1;
+    histoImg = Mat::zeros(imageHeight, (int) colHeights.size(), CV_8U);
+
+    // Each column is filled from the bottom of the image up to its height
+    for (int row = 0; row < histoImg.rows; row++)
+    {
+      uchar* histoRow = histoImg.ptr<uchar>(row);
+      int minHeight = imageHeight - row;
+
+      for (int col = 0; col < histoImg.cols; col++)
+        histoRow[col] = colHeights[col] >= minHeight ? 255 : 0;
+    }
+  }
+
+  int VerticalHistogram::getLocalMinimum(int leftX, int rightX) const
+  {
+    int minimum = imageHeight + 1;
     int lowestX = leftX;
 
     for (int i = leftX; i <= rightX; i++)
@@ -118,7 +134,7 @@ namespace alpr
     return lowestX;
   }
 
-  int VerticalHistogram::getLocalMaximum(int leftX, int rightX)
+  int VerticalHistogram::getLocalMaximum(int leftX, int rightX) const
   {
     int maximum = -1;
     int highestX = leftX;
@@ -135,11 +151,21 @@ namespace alpr
     return highestX;
   }
 
-  int VerticalHistogram::getHeightAt(int x)
+  int VerticalHistogram::getHeightAt(int x) const
   {
     return colHeights[x];
   }
 
+  int VerticalHistogram::getWidth() const
+  {
+    return colHeights.size();
+  }
+
+  int VerticalHistogram::getImageHeight() const
+  {
+    return imageHeight;
+  }
+
   int VerticalHistogram::detect_peak(
         const double*   data, /* the data */ 
         int             data_count, /* row count of data */ 
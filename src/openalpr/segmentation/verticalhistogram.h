@@ -40,25 +40,31 @@ namespace alpr
   {
 
     public:
-      VerticalHistogram(cv::Mat inputImage, cv::Mat mask);
+      VerticalHistogram(const cv::Mat& inputImage, const cv::Mat& mask, bool createHistogramImage = false);
       virtual ~VerticalHistogram();
 
+      // Only populated when createHistogramImage is set (used for debugging)
       cv::Mat histoImg;
 
       // Returns the lowest X position between two points.
-      int getLocalMinimum(int leftX, int rightX);
+      int getLocalMinimum(int leftX, int rightX) const;
       // Returns the highest X position between two points.
-      int getLocalMaximum(int leftX, int rightX);
+      int getLocalMaximum(int leftX, int rightX) const;
 
-      int getHeightAt(int x);
+      int getHeightAt(int x) const;
+
+      int getWidth() const;
+      int getImageHeight() const;
 
     private:
       std::vector<int> colHeights;
+      int imageHeight;
       int highestPeak;
       int lowestValley;
       std::vector<Valley> valleys;
 
-      void analyzeImage(cv::Mat inputImage, cv::Mat mask);
+      void analyzeImage(const cv::Mat& inputImage, const cv::Mat& mask);
+      void drawHistogramImage();
       
       int detect_peak(const double* data,  int data_count, int* emi_peaks, 
                       int* num_emi_peaks, int max_emi_peaks, int* absop_peaks,
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "allocationcounter.h"
+
+#include <new>
+#include <stdlib.h>
+
+static size_t allocationCount = 0;
+
+size_t getAllocationCount()
+{
+  return allocationCount;
+}
+
+void* operator new(size_t size)
+{
+  allocationCount++;
+
+  void* memory = malloc(size == 0 ? 1 : size);
+  if (memory == NULL)
+    throw std::bad_alloc();
+
+  return memory;
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* memory)
+{
+  free(memory);
+}
+
+void operator delete[](void* memory)
+{
+  free(memory);
+}
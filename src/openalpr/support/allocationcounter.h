@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2015 OpenALPR Technology, Inc.
+ * Open source Automated License Plate Recognition [http://www.openalpr.com]
+ *
+ * This file is part of OpenALPR.
+ *
+ * OpenALPR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License
+ * version 3 as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENALPR_ALLOCATIONCOUNTER_H
+#define OPENALPR_ALLOCATIONCOUNTER_H
+
+#include <stddef.h>
+
+// The benchmark replaces the global operator new and delete to count heap allocations, including
+// the ones made inside the openalpr library.  allocationcounter.cpp is compiled into the benchmark
+// only, never into the support library, so applications keep their own operator new.  cv::Mat
+// buffers come from malloc and are not counted.  The count is not synchronized, so it is only exact
+// while a single thread allocates.
+size_t getAllocationCount();
+
+#endif // OPENALPR_ALLOCATIONCOUNTER_H
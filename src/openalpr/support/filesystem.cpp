@@ -123,6 +123,7 @@ namespace alpr
   static int makeDir(char *path, mode_t mode) { return 0; }
   bool makePath(char* path, mode_t mode) { return true; }
   int64_t getFileCreationTime(std::string filename) { return 0; }
+  int64_t getFileModificationTime(std::string filename) { return 0; }
 
   #else
 
@@ -156,6 +157,18 @@ namespace alpr
       return (int64_t) milliseconds;
   }
 
+  // Seconds since the epoch, or 0 if the file can't be read
+  int64_t getFileModificationTime(std::string filename)
+  {
+      struct stat stat_buf;
+      int rc = stat(filename.c_str(), &stat_buf);
+
+      if (rc != 0)
+        return 0;
+
+      return (int64_t) stat_buf.st_mtime;
+  }
+
   static int makeDir(const char *path, mode_t mode)
   {
     struct stat            st;
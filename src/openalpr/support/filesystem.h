@@ -33,6 +33,7 @@ namespace alpr
 
   int64_t getFileSize(std::string filename);
   int64_t getFileCreationTime(std::string filename);
+  int64_t getFileModificationTime(std::string filename);
 
   bool DirectoryExists( const char* pzPath );
   bool fileExists( const char* pzPath );
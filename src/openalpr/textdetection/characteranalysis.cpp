@@ -51,8 +51,8 @@ namespace alpr
     timespec startTime;
     getTimeMonotonic(&startTime);
 
-    pipeline_data->clearThresholds();
-    pipeline_data->thresholds = produceThresholds(pipeline_data->crop_gray, config);
+    pipeline_data->prepareThresholds(PipelineData::SCRATCH_ANALYSIS_THRESHOLDS);
+    produceThresholds(pipeline_data->crop_gray, config, pipeline_data->thresholds);
 
     timespec contoursStartTime;
     getTimeMonotonic(&contoursStartTime);
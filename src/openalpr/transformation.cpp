@@ -89,17 +89,18 @@ namespace alpr
 
   Mat Transformation::crop(Size outputImageSize, Mat transformationMatrix)
   {
+    Mat deskewed;
+    crop(outputImageSize, transformationMatrix, deskewed);
 
+    return deskewed;
+  }
 
-    Mat deskewed(outputImageSize, this->bigImage.type());
+  void Transformation::crop(Size outputImageSize, Mat transformationMatrix, Mat& output)
+  {
+    output.create(outputImageSize, this->bigImage.type());
 
     // Apply perspective transformation to the image
-    warpPerspective(this->bigImage, deskewed, transformationMatrix, deskewed.size(), INTER_CUBIC);
-
-
-
-
-    return deskewed;
+    warpPerspective(this->bigImage, output, transformationMatrix, output.size(), INTER_CUBIC);
   }
 
   vector<Point2f> Transformation::remapSmallPointstoCrop(vector<Point> smallPoints, cv::Mat transformationMatrix)
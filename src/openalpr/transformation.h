@@ -38,6 +38,8 @@ namespace alpr
     cv::Mat getTransformationMatrix(std::vector<cv::Point2f> corners, std::vector<cv::Point2f> outputCorners);
 
     cv::Mat crop(cv::Size outputImageSize, cv::Mat transformationMatrix);
+    // Writes the crop into output, reusing its buffer when it already has the right size and type
+    void crop(cv::Size outputImageSize, cv::Mat transformationMatrix, cv::Mat& output);
     std::vector<cv::Point2f> remapSmallPointstoCrop(std::vector<cv::Point> smallPoints, cv::Mat transformationMatrix);
     std::vector<cv::Point2f> remapSmallPointstoCrop(std::vector<cv::Point2f> smallPoints, cv::Mat transformationMatrix);
 
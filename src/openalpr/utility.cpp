@@ -125,16 +125,23 @@ namespace alpr
 
   vector<Mat> produceThresholds(const Mat img_gray, Config* config)
   {
-    const int THRESHOLD_COUNT = 3;
+    vector<Mat> thresholds;
+    produceThresholds(img_gray, config, thresholds);
+
+    return thresholds;
+  }
+
+  void produceThresholds(const Mat img_gray, Config* config, vector<Mat>& thresholds)
+  {
     //Mat img_equalized = equalizeBrightness(img_gray);
 
     timespec startTime;
     getTimeMonotonic(&startTime);
 
-    vector<Mat> thresholds;
+    thresholds.resize(THRESHOLD_COUNT);
 
     for (int i = 0; i < THRESHOLD_COUNT; i++)
-      thresholds.push_back(Mat(img_gray.size(), CV_8U));
+      thresholds[i].create(img_gray.size(), CV_8U);
 
     int i = 0;
 
@@ -171,8 +178,6 @@ namespace alpr
       getTimeMonotonic(&endTime);
       cout << "  -- Produce Threshold Time: " << diffclock(startTime, endTime) << "ms." << endl;
     }
-
-    return thresholds;
     //threshold(img_equalized, img_threshold, 100, 255, THRESH_BINARY);
   }
 
@@ -75,7 +75,13 @@ namespace alpr
 
   double median(int array[], int arraySize);
 
+  // Number of thresholded images produced for each plate crop
+  const int THRESHOLD_COUNT = 3;
+
   std::vector<cv::Mat> produceThresholds(const cv::Mat img_gray, Config* config);
+  // Fills thresholds with THRESHOLD_COUNT images.  Images already in the vector keep their
+  // buffers when they have the size of img_gray.
+  void produceThresholds(const cv::Mat img_gray, Config* config, std::vector<cv::Mat>& thresholds);
 
   cv::Mat drawImageDashboard(std::vector<cv::Mat> images, int imageType, unsigned int numColumns);
 
@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include "catch.hpp"
 #include "alpr.h"
+#include "alpr_binary.h"
 #include "support/timing.h"
 
 
@@ -93,3 +94,121 @@ TEST_CASE( "JSON Serialization/Deserialization", "[json]" ) {
   }
   
 }
+
+TEST_CASE( "JSON Validation", "[json]" ) {
+
+  AlprResults results;
+  std::string error;
+
+  // Fields alprd adds and unknown members are skipped
+  REQUIRE( Alpr::fromJson("{\"processing_time_ms\":12.5,\"results\":[{\"plate\":\"ABC\",\"candidates\":[]}],\"uuid\":\"x\"}", results, error) );
+  REQUIRE( results.total_processing_time_ms == 12.5 );
+  REQUIRE( results.plates.size() == 1 );
+  REQUIRE( results.plates[0].bestPlate.characters == "ABC" );
+
+  // Character details are read for the candidates, and the best plate gets those of its candidate
+  REQUIRE( Alpr::fromJson("{\"results\":[{\"plate\":\"B\",\"candidates\":[{\"plate\":\"A\"},{\"plate\":\"B\",\"character_details\":"
+                          "[{\"character\":\"B\",\"confidence\":50,\"coordinates\":[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4},{\"x\":5,\"y\":6},{\"x\":7,\"y\":8}]}]}]}]}",
+                          results, error) );
+  REQUIRE( results.plates[0].bestPlate.character_details.size() == 1 );
+  REQUIRE( results.plates[0].bestPlate.character_details[0].corners[3].y == 8 );
+
+  // Malformed or incomplete JSON is reported instead of crashing
+  REQUIRE( Alpr::fromJson("", results, error) == false );
+  REQUIRE( Alpr::fromJson("{\"results\":[{\"plate\":\"ABC\"}", results, error) == false );
+  REQUIRE( Alpr::fromJson("{\"epoch_time\":1}", results, error) == false );
+  REQUIRE( error.find("Missing results") != std::string::npos );
+  REQUIRE( Alpr::fromJson("{\"results\":[{\"confidence\":1}]}", results, error) == false );
+  REQUIRE( Alpr::fromJson("{\"results\":[{\"plate\":\"A\",\"coordinates\":[{\"x\":1}]}]}", results, error) == false );
+  REQUIRE( Alpr::fromJson("{\"img_width\":\"640\",\"results\":[]}", results, error) == false );
+}
+
+TEST_CASE( "Binary Serialization/Deserialization", "[binary]" ) {
+
+  AlprResults origResults;
+  origResults.epoch_time = getEpochTimeMs();
+  origResults.img_width = 640;
+  origResults.img_height = 480;
+  origResults.total_processing_time_ms = 100.5;
+  origResults.regionsOfInterest.push_back(AlprRegionOfInterest(259,260,50,150));
+
+  AlprPlateResult apr;
+  for (int i = 0; i < 3; i++)
+  {
+    AlprPlate ap;
+    ap.characters = "ab" + std::string(1, '0' + i);
+    ap.matches_template = i%2;
+    ap.overall_confidence = i * 10.25;
+    for (int c = 0; c < 3; c++)
+    {
+      AlprChar ac;
+      ac.character = ap.characters.substr(c, 1);
+      ac.confidence = c * 20;
+      for (int p = 0; p < 4; p++)
+      {
+        ac.corners[p].x = c * 10 + p;
+        ac.corners[p].y = i;
+      }
+      ap.character_details.push_back(ac);
+    }
+    apr.topNPlates.push_back(ap);
+  }
+  apr.bestPlate = apr.topNPlates[1];
+  for (int i = 0; i < 4; i++)
+  {
+    apr.plate_points[i].x = i;
+    apr.plate_points[i].y = -i;
+  }
+
+  apr.plate_index = 0;
+  apr.processing_time_ms = 30.5;
+  apr.requested_topn = 10;
+  apr.region = "mo";
+  apr.regionConfidence = 80;
+
+  origResults.plates.push_back(apr);
+
+  std::string resultsBinary = Alpr::toBinary(origResults);
+  AlprResults roundTrip = Alpr::fromBinary(resultsBinary);
+
+  REQUIRE( roundTrip.epoch_time == origResults.epoch_time );
+  REQUIRE( roundTrip.img_width == origResults.img_width );
+  REQUIRE( roundTrip.img_height == origResults.img_height );
+  REQUIRE( roundTrip.total_processing_time_ms == origResults.total_processing_time_ms );
+  REQUIRE( roundTrip.regionsOfInterest.size() == 1 );
+  REQUIRE( roundTrip.regionsOfInterest[0].height == 150 );
+
+  REQUIRE( roundTrip.plates.size() == 1 );
+  AlprPlateResult& plate = roundTrip.plates[0];
+  REQUIRE( plate.processing_time_ms == apr.processing_time_ms );
+  REQUIRE( plate.region == apr.region );
+  REQUIRE( plate.regionConfidence == apr.regionConfidence );
+  REQUIRE( plate.requested_topn == apr.requested_topn );
+  REQUIRE( plate.plate_points[3].y == -3 );
+  REQUIRE( plate.bestPlate.characters == "ab1" );
+  REQUIRE( plate.bestPlate.matches_template == true );
+
+  REQUIRE( plate.topNPlates.size() == apr.topNPlates.size() );
+  for (int j = 0; j < plate.topNPlates.size(); j++)
+  {
+    REQUIRE( plate.topNPlates[j].characters == apr.topNPlates[j].characters );
+    REQUIRE( plate.topNPlates[j].overall_confidence == apr.topNPlates[j].overall_confidence );
+    REQUIRE( plate.topNPlates[j].character_details.size() == 3 );
+    REQUIRE( plate.topNPlates[j].character_details[2].character == apr.topNPlates[j].character_details[2].character );
+    REQUIRE( plate.topNPlates[j].character_details[2].confidence == 40 );
+    REQUIRE( plate.topNPlates[j].character_details[2].corners[1].x == 21 );
+  }
+
+  // The reader gives the same values without copying them out
+  AlprResultsReader reader(resultsBinary.data(), resultsBinary.size());
+  REQUIRE( reader.isValid() );
+  REQUIRE( reader.getMessageLength() == resultsBinary.size() );
+  REQUIRE( reader.getPlateCount() == 1 );
+  REQUIRE( reader.getPlate(0).getCandidate(2).getCharacters().str() == "ab2" );
+  REQUIRE( reader.getPlate(0).getBestPlate().getCharacter(0).getCharacter().str() == "a" );
+
+  // Truncated messages are rejected
+  AlprResultsReader truncated(resultsBinary.data(), resultsBinary.size() - 1);
+  REQUIRE( truncated.isValid() == false );
+  REQUIRE( Alpr::fromBinary(resultsBinary.substr(0, 20)).plates.size() == 0 );
+}
@@ -92,6 +92,33 @@ TEST_CASE( "Unicode tests", "[Regex]" ) {
 }
 
 
+TEST_CASE( "Character class tests", "[Regex]" ) {
+
+  RegexRule rule1("us", "[^A-C0]#?#");
+
+  REQUIRE( rule1.match("A1X2") == false);
+  REQUIRE( rule1.match("C1X2") == false);
+  REQUIRE( rule1.match("01X2") == false);
+  REQUIRE( rule1.match("D1X") == false);
+
+  REQUIRE( rule1.match("D1X2") == true);
+  REQUIRE( rule1.match("口1X2") == true);
+  REQUIRE( rule1.match("-112") == true);
+
+  RegexRule rule2("us", "[가-힣-]@");
+
+  REQUIRE( rule2.match("A가") == false);
+  REQUIRE( rule2.match("1가") == false);
+
+  REQUIRE( rule2.match("팔가") == true);
+  REQUIRE( rule2.match("-A") == true);
+
+  REQUIRE( rule2.matchesPosition(0, "십") == true);
+  REQUIRE( rule2.matchesPosition(0, "십팔") == false);
+  REQUIRE( rule2.matchesPosition(1, "1") == false);
+  REQUIRE( rule2.matchesPosition(2, "A") == false);
+}
+
 TEST_CASE( "Invalid tests", "[Regex]" ) {
   RegexRule rule1("us", "[A@@####");
   
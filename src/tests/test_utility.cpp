@@ -7,7 +7,11 @@
 
 #include <cstdlib>
 #include "utility.h"
+#include "framecontext.h"
+#include "licenseplatecandidate.h"
+#include "stateidentifier.h"
 #include "catch.hpp"
+#include "opencv2/highgui/highgui.hpp"
 
 using namespace std;
 using namespace cv;
@@ -58,4 +62,105 @@ TEST_CASE( "Test Levenshtein Distance", "[levenshtein]" ) {
   
   REQUIRE( levenshteinDistance("", "AAAA", 2) == 2 );
   REQUIRE( levenshteinDistance("BA", "AAAA", 2) == 2 );
-}
\ No newline at end of file
+}
+
+
+// Runs the plate stages of the pipeline on a frame the way AlprImpl does: gray conversion, then plate
+// analysis, edge finding, deskewing and character segmentation for each region, in a recycled pipeline data
+static void processFrame(FrameContext& frameContext, Config* config, Mat frame, const vector<Rect>& plateRegions)
+{
+  Mat grayImg = frameContext.convertToGray(frame);
+
+  for (unsigned int i = 0; i < plateRegions.size(); i++)
+  {
+    PipelineData* pipeline_data = frameContext.beginPlate(frame, grayImg, plateRegions[i], config);
+
+    LicensePlateCandidate lp(pipeline_data);
+    lp.recognize();
+  }
+
+  frameContext.endFrame();
+}
+
+TEST_CASE( "Frame context steady state", "[framecontext]" ) {
+
+  Config config("us", OPENALPR_TEST_CONFIG_FILE, OPENALPR_TEST_RUNTIME_DIR);
+  REQUIRE( config.loaded );
+  config.debugOff();
+
+  Mat plate = imread(string(OPENALPR_TEST_RUNTIME_DIR) + "/keypoints/us/ca1993.jpg");
+  REQUIRE( plate.empty() == false );
+
+  // A fixed size video of two plates, with different noise around them in each frame
+  vector<Rect> plateRegions;
+  plateRegions.push_back(Rect(40, 60, plate.cols, plate.rows));
+  plateRegions.push_back(Rect(340, 260, plate.cols, plate.rows));
+
+  vector<Mat> frames;
+  for (int i = 0; i < 6; i++)
+  {
+    Mat frame(480, 640, CV_8UC3);
+    randu(frame, Scalar::all(0), Scalar::all(255));
+    for (unsigned int p = 0; p < plateRegions.size(); p++)
+      plate.copyTo(frame(plateRegions[p]));
+    frames.push_back(frame);
+  }
+
+  FrameContext frameContext;
+
+  processFrame(frameContext, &config, frames[0], plateRegions);
+
+  REQUIRE( frameContext.getAllocationCount() > 0 );
+  frameContext.resetAllocationCount();
+
+  // No buffer that the frame context recycles is allocated again once it has warmed up
+  for (unsigned int i = 1; i < frames.size(); i++)
+  {
+    processFrame(frameContext, &config, frames[i], plateRegions);
+    REQUIRE( frameContext.getAllocationCount() == 0 );
+  }
+}
+
+TEST_CASE( "Frame context resets the region between plates", "[framecontext]" ) {
+
+  Config config("us", OPENALPR_TEST_CONFIG_FILE, OPENALPR_TEST_RUNTIME_DIR);
+  REQUIRE( config.loaded );
+  config.debugOff();
+
+  StateIdentifier stateIdentifier(&config);
+
+  Mat plate = imread(string(OPENALPR_TEST_RUNTIME_DIR) + "/keypoints/us/ca1993.jpg");
+  REQUIRE( plate.empty() == false );
+
+  // A plate that the state identifier knows, followed by a region of noise
+  Mat frame(480, 640, CV_8UC3);
+  randu(frame, Scalar::all(0), Scalar::all(255));
+  Rect plateRegion(40, 60, plate.cols, plate.rows);
+  plate.copyTo(frame(plateRegion));
+
+  vector<Rect> plateRegions;
+  plateRegions.push_back(plateRegion);
+  plateRegions.push_back(Rect(340, 260, plate.cols, plate.rows));
+
+  FrameContext frameContext;
+  Mat grayImg = frameContext.convertToGray(frame);
+
+  for (unsigned int i = 0; i < plateRegions.size(); i++)
+  {
+    PipelineData* pipeline_data = frameContext.beginPlate(frame, grayImg, plateRegions[i], &config);
+
+    // Nothing is carried over from the previous plate in the recycled pipeline data
+    REQUIRE( pipeline_data->region_code == "" );
+    REQUIRE( pipeline_data->region_confidence == 0 );
+
+    LicensePlateCandidate lp(pipeline_data);
+    lp.recognize();
+    if (pipeline_data->disqualified == false)
+      stateIdentifier.recognize(pipeline_data);
+
+    // A confidence always comes with the region it belongs to
+    REQUIRE( (pipeline_data->region_confidence == 0 || pipeline_data->region_code != "") );
+  }
+
+  frameContext.endFrame();
+}
@@ -28,6 +28,7 @@ void getALPRImages(cv::VideoCapture cap, VideoDispatcher* dispatcher);
 VideoBuffer::VideoBuffer()
 {
   dispatcher = NULL;
+  grayscale = false;
   
 }
 
@@ -68,11 +69,17 @@ void VideoBuffer::connect(std::string mjpeg_url, int fps)
     }
     
     dispatcher = createDispatcher(mjpeg_url, fps);
+    dispatcher->grayscale = grayscale;
       
     tthread::thread* t = new tthread::thread(imageCollectionThread, (void*) dispatcher);
     
 }
 
+void VideoBuffer::setGrayscale(bool grayscale)
+{
+  this->grayscale = grayscale;
+}
+
 int VideoBuffer::getLatestFrame(cv::Mat* frame, std::vector<cv::Rect>& regionsOfInterest)
 {
   if (dispatcher == NULL)
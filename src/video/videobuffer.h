@@ -6,6 +6,7 @@
 #include <sstream>
 
 #include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
 
 #include "support/filesystem.h"
 #include "support/tinythread.h"
@@ -21,6 +22,7 @@ class VideoDispatcher
       this->active = true;
       this->latestFrameNumber = -1;
       this->lastFrameRead = -1;
+      this->grayscale = false;
       this->fps = fps;
       this->mjpeg_url = mjpeg_url;
     }
@@ -47,7 +49,10 @@ class VideoDispatcher
     
     void setLatestFrame(cv::Mat frame)
     {      
-      frame.copyTo(this->latestFrame);
+      if (grayscale && frame.channels() > 2)
+        cv::cvtColor(frame, this->latestFrame, CV_BGR2GRAY);
+      else
+        frame.copyTo(this->latestFrame);
       this->latestRegionsOfInterest = calculateRegionsOfInterest(&this->latestFrame);
       
       this->latestFrameNumber++;
@@ -74,6 +79,9 @@ class VideoDispatcher
     
     bool active;
     
+    // Keeps the frames as grayscale, which makes them a third of the size to copy
+    bool grayscale;
+    
     int latestFrameNumber;
     int lastFrameRead;
     
@@ -95,6 +103,9 @@ class VideoBuffer
 
     void connect(std::string mjpeg_url, int fps);
     
+    // Converts the frames to grayscale as they arrive.  Must be set before connecting.
+    void setGrayscale(bool grayscale);
+    
 
     // If a new frame is available, the function sets "frame" to it and returns the frame number
     // If no frames are available, or the latest has already been grabbed, returns -1.
@@ -111,6 +122,7 @@ class VideoBuffer
     
     
     VideoDispatcher* dispatcher;
+    bool grayscale;
 };
 
 